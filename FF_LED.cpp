@@ -6,6 +6,266 @@
 */
 
 #include "FF_LED.h"
+#include "FF_LEDGroup.h"
+#include "FF_LEDOutput.h"
+#if defined(FF_LED_TIMER_DRIVEN) && defined(ESP32)
+    portMUX_TYPE ffLedMux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+#if defined(FF_LED_TIMER_DRIVEN) && (defined(ESP32) || defined(ESP8266))
+    #define FF_LED_GAMMA_ATTR                   // Flash can't be read from timer interrupt, keep table in RAM
+#else
+    #define FF_LED_GAMMA_ATTR PROGMEM
+#endif
+
+#if FF_LED_LEVEL_BITS == 8
+    #if FF_LED_GAMMA == FF_LED_GAMMA_22
+    // Generated by round(255 * pow(i / 255.0, 2.2))
+    static const uint8_t ledGammaTable[256] FF_LED_GAMMA_ATTR = {
+          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+          1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+          3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+          6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+         12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+         20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+         30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+         42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+         56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+         73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+         91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+        113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+        137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+        163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+        192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+        223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255
+    };
+    #elif FF_LED_GAMMA == FF_LED_GAMMA_CIE
+    // Generated by L = i * 100 / 255.0, round(255 * (L <= 8 ? L / 903.3 : pow((L + 16) / 116, 3)))
+    static const uint8_t ledGammaTable[256] FF_LED_GAMMA_ATTR = {
+          0,   0,   0,   0,   0,   1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,
+          2,   2,   2,   2,   2,   2,   2,   3,   3,   3,   3,   3,   3,   3,   3,   4,
+          4,   4,   4,   4,   4,   5,   5,   5,   5,   5,   6,   6,   6,   6,   6,   7,
+          7,   7,   7,   8,   8,   8,   8,   9,   9,   9,  10,  10,  10,  10,  11,  11,
+         11,  12,  12,  12,  13,  13,  13,  14,  14,  15,  15,  15,  16,  16,  17,  17,
+         17,  18,  18,  19,  19,  20,  20,  21,  21,  22,  22,  23,  23,  24,  24,  25,
+         25,  26,  26,  27,  28,  28,  29,  29,  30,  31,  31,  32,  32,  33,  34,  34,
+         35,  36,  37,  37,  38,  39,  39,  40,  41,  42,  43,  43,  44,  45,  46,  47,
+         47,  48,  49,  50,  51,  52,  53,  54,  54,  55,  56,  57,  58,  59,  60,  61,
+         62,  63,  64,  65,  66,  67,  68,  70,  71,  72,  73,  74,  75,  76,  77,  79,
+         80,  81,  82,  83,  85,  86,  87,  88,  90,  91,  92,  94,  95,  96,  98,  99,
+        100, 102, 103, 105, 106, 108, 109, 110, 112, 113, 115, 116, 118, 120, 121, 123,
+        124, 126, 128, 129, 131, 132, 134, 136, 138, 139, 141, 143, 145, 146, 148, 150,
+        152, 154, 155, 157, 159, 161, 163, 165, 167, 169, 171, 173, 175, 177, 179, 181,
+        183, 185, 187, 189, 191, 193, 196, 198, 200, 202, 204, 207, 209, 211, 214, 216,
+        218, 220, 223, 225, 228, 230, 232, 235, 237, 240, 242, 245, 247, 250, 252, 255
+    };
+    #endif
+#else
+    // Wide levels: 16 bits table on 257 points, interpolated and scaled to FF_LED_LEVEL_BITS
+    #if FF_LED_GAMMA == FF_LED_GAMMA_22
+    // Generated by round(65535 * pow(i / 256.0, 2.2))
+    static const uint16_t ledGammaTable[257] FF_LED_GAMMA_ATTR = {
+            0,     0,     2,     4,     7,    11,    17,    24,    32,    41,    52,    64,
+           78,    93,   110,   128,   147,   168,   191,   215,   240,   267,   296,   327,
+          359,   392,   428,   465,   504,   544,   586,   630,   676,   723,   772,   823,
+          875,   930,   986,  1044,  1104,  1165,  1229,  1294,  1361,  1430,  1501,  1574,
+         1648,  1725,  1803,  1884,  1966,  2050,  2136,  2224,  2314,  2406,  2500,  2595,
+         2693,  2793,  2895,  2998,  3104,  3212,  3322,  3433,  3547,  3663,  3781,  3900,
+         4022,  4146,  4272,  4400,  4530,  4663,  4797,  4933,  5072,  5212,  5355,  5499,
+         5646,  5795,  5946,  6099,  6255,  6412,  6572,  6733,  6897,  7063,  7231,  7402,
+         7574,  7749,  7926,  8105,  8286,  8469,  8655,  8843,  9033,  9225,  9419,  9616,
+         9815, 10016, 10219, 10425, 10632, 10842, 11054, 11269, 11486, 11705, 11926, 12149,
+        12375, 12603, 12833, 13066, 13301, 13538, 13777, 14019, 14263, 14509, 14758, 15009,
+        15262, 15517, 15775, 16035, 16298, 16563, 16830, 17099, 17371, 17645, 17922, 18201,
+        18482, 18765, 19051, 19339, 19630, 19923, 20218, 20516, 20816, 21119, 21424, 21731,
+        22040, 22352, 22667, 22984, 23303, 23624, 23949, 24275, 24604, 24935, 25269, 25605,
+        25943, 26284, 26628, 26973, 27322, 27672, 28026, 28381, 28739, 29100, 29462, 29828,
+        30196, 30566, 30939, 31314, 31692, 32072, 32454, 32840, 33227, 33617, 34010, 34405,
+        34802, 35202, 35605, 36010, 36417, 36827, 37240, 37655, 38072, 38493, 38915, 39340,
+        39768, 40198, 40631, 41066, 41503, 41944, 42387, 42832, 43280, 43730, 44183, 44639,
+        45097, 45557, 46020, 46486, 46954, 47425, 47899, 48374, 48853, 49334, 49818, 50304,
+        50793, 51284, 51778, 52275, 52774, 53276, 53780, 54287, 54796, 55308, 55823, 56341,
+        56860, 57383, 57908, 58436, 58966, 59499, 60035, 60573, 61114, 61657, 62203, 62752,
+        63303, 63857, 64414, 64973, 65535
+    };
+    #elif FF_LED_GAMMA == FF_LED_GAMMA_CIE
+    // Generated by L = i * 100 / 256.0, round(65535 * (L <= 8 ? L / 903.3 : pow((L + 16) / 116, 3)))
+    static const uint16_t ledGammaTable[257] FF_LED_GAMMA_ATTR = {
+            0,    28,    57,    85,   113,   142,   170,   198,   227,   255,   283,   312,
+          340,   368,   397,   425,   453,   482,   510,   538,   567,   595,   625,   655,
+          686,   718,   751,   785,   821,   857,   894,   933,   972,  1012,  1054,  1097,
+         1141,  1186,  1232,  1279,  1328,  1378,  1429,  1481,  1535,  1590,  1646,  1703,
+         1762,  1822,  1883,  1946,  2010,  2076,  2143,  2211,  2281,  2352,  2425,  2500,
+         2575,  2653,  2731,  2812,  2894,  2977,  3062,  3149,  3237,  3327,  3419,  3512,
+         3607,  3704,  3802,  3902,  4004,  4108,  4213,  4320,  4429,  4540,  4652,  4767,
+         4883,  5001,  5121,  5243,  5367,  5493,  5621,  5751,  5882,  6016,  6152,  6289,
+         6429,  6571,  6715,  6861,  7009,  7159,  7312,  7466,  7623,  7782,  7943,  8106,
+         8272,  8439,  8609,  8781,  8956,  9133,  9312,  9493,  9677,  9863, 10052, 10243,
+        10436, 10632, 10830, 11030, 11234, 11439, 11647, 11858, 12071, 12286, 12504, 12725,
+        12948, 13174, 13403, 13634, 13868, 14104, 14343, 14585, 14830, 15077, 15327, 15579,
+        15835, 16093, 16354, 16618, 16885, 17154, 17426, 17702, 17980, 18261, 18545, 18831,
+        19121, 19414, 19710, 20008, 20310, 20615, 20922, 21233, 21547, 21864, 22184, 22507,
+        22833, 23163, 23495, 23831, 24170, 24512, 24857, 25206, 25558, 25913, 26271, 26632,
+        26997, 27366, 27737, 28112, 28490, 28872, 29257, 29645, 30037, 30432, 30831, 31233,
+        31639, 32048, 32461, 32877, 33297, 33720, 34147, 34578, 35012, 35450, 35891, 36336,
+        36785, 37237, 37693, 38153, 38616, 39083, 39554, 40029, 40507, 40990, 41476, 41966,
+        42460, 42957, 43459, 43964, 44473, 44987, 45504, 46025, 46550, 47079, 47612, 48149,
+        48690, 49235, 49785, 50338, 50895, 51457, 52022, 52592, 53166, 53744, 54326, 54912,
+        55503, 56097, 56696, 57300, 57907, 58519, 59135, 59755, 60380, 61009, 61642, 62280,
+        62922, 63569, 64220, 64875, 65535
+    };
+    #endif
+#endif
+
+#if defined(FF_LED_TIMER_DRIVEN) && (defined(ESP32) || defined(ESP8266))
+    #define FF_LED_GAMMA_READ(_index) (ledGammaTable[_index])
+#elif FF_LED_LEVEL_BITS == 8
+    #define FF_LED_GAMMA_READ(_index) (pgm_read_byte(&ledGammaTable[_index]))
+#else
+    #define FF_LED_GAMMA_READ(_index) (pgm_read_word(&ledGammaTable[_index]))
+#endif
+
+#if FF_LED_GAMMA != FF_LED_GAMMA_NONE
+/*!
+
+	\brief	Apply brightness curve
+
+	Convert LED level to PWM value using gamma table. Wide levels interpolate 16 bits table between
+	the 2 points around level, then scale result to FF_LED_LEVEL_BITS.
+
+	\param[in]	_level: LED level (0-FF_LED_MAX_LEVEL)
+	\return	PWM value (0-FF_LED_MAX_LEVEL)
+
+*/
+static FF_LEDCore::ledLevelType FF_LED_IRAM_ATTR gammaLevel(FF_LEDCore::ledLevelType _level) {
+    #if FF_LED_LEVEL_BITS == 8
+        return FF_LED_GAMMA_READ(_level);
+    #else
+        if (_level >= FF_LED_MAX_LEVEL) {
+            return FF_LED_MAX_LEVEL;            // Full scale stays full scale
+        }
+        uint8_t index = _level >> (FF_LED_LEVEL_BITS - 8);
+        uint32_t fraction = _level & ((1UL << (FF_LED_LEVEL_BITS - 8)) - 1);
+        uint32_t low = FF_LED_GAMMA_READ(index);
+        uint32_t high = FF_LED_GAMMA_READ(index + 1);
+        uint32_t value = low + (((high - low) * fraction) >> (FF_LED_LEVEL_BITS - 8));
+        return value >> (16 - FF_LED_LEVEL_BITS);
+    #endif
+}
+    #define FF_LED_GAMMA_LEVEL(_level) gammaLevel(_level)
+#else
+    #define FF_LED_GAMMA_LEVEL(_level) (_level)
+#endif
+
+#ifdef FF_LED_BRIGHTNESS
+FF_LEDCore::ledLevelType FF_LEDCore::ledBrightness = FF_LED_MAX_LEVEL;
+uint8_t FF_LEDCore::ledBrightnessSerial = 0;
+#if FF_LED_LEVEL_BITS == 8
+    static uint8_t ledOutputTable[256];         // Brightness curve and global brightness, computed by setBrightness()
+    static struct ledOutputTableInit {
+        ledOutputTableInit() {FF_LEDCore::setBrightness(FF_LED_MAX_LEVEL);}
+    } ledOutputTableInitializer;                // Fill table at startup
+#else
+    static uint32_t ledBrightnessFactor = FF_LED_MAX_LEVEL + 1; // Global brightness, scaled to 1 << FF_LED_LEVEL_BITS
+#endif
+
+/*!
+
+	\brief	Set global brightness
+
+	Scale output of all LEDs (after brightness curve), without changing their levels nor their effects.
+	With 8 bits levels, output table (256 bytes of RAM) is computed here once, so that writes only read it.
+	Wider levels are scaled by a multiplication on each write.
+
+	FF_LED and FF_LEDSync write their new output on next loop() (even when idle), as well as groups.
+	FF_LEDT and FF_LEDBatch use new brightness when their LEDs next change.
+
+	\param[in]	_brightness: brightness (0-FF_LED_MAX_LEVEL, FF_LED_MAX_LEVEL for full brightness)
+	\return	none
+
+*/
+void FF_LEDCore::setBrightness(ledLevelType _brightness) {
+    #if FF_LED_LEVEL_BITS == 8
+        uint16_t factor = (uint16_t) _brightness + 1;
+        for (uint16_t i = 0; i < 256; i++) {
+            ledOutputTable[i] = (FF_LED_GAMMA_LEVEL(i) * factor) >> 8;
+        }
+    #else
+        ledBrightnessFactor = (uint32_t) _brightness + 1;
+    #endif
+    ledBrightness = _brightness;
+    ledBrightnessSerial++;                      // Ask LEDs to write their output again
+}
+
+/*!
+
+	\brief	Return global brightness
+
+	\return	brightness set by setBrightness() (FF_LED_MAX_LEVEL by default)
+
+*/
+FF_LEDCore::ledLevelType FF_LEDCore::getBrightness(void) {
+    return ledBrightness;
+}
+
+/*!
+
+	\brief	Apply brightness curve and global brightness
+
+	\param[in]	_level: LED level (0-FF_LED_MAX_LEVEL)
+	\return	PWM value (0-FF_LED_MAX_LEVEL)
+
+*/
+FF_LEDCore::ledLevelType FF_LED_IRAM_ATTR FF_LEDCore::outputLevel(ledLevelType _level) {
+    #if FF_LED_LEVEL_BITS == 8
+        return ledOutputTable[_level];
+    #else
+        return ((uint32_t) FF_LED_GAMMA_LEVEL(_level) * ledBrightnessFactor) >> FF_LED_LEVEL_BITS;
+    #endif
+}
+#elif FF_LED_GAMMA != FF_LED_GAMMA_NONE
+/*!
+
+	\brief	Apply brightness curve
+
+	\param[in]	_level: LED level (0-FF_LED_MAX_LEVEL)
+	\return	PWM value (0-FF_LED_MAX_LEVEL)
+
+*/
+FF_LEDCore::ledLevelType FF_LED_IRAM_ATTR FF_LEDCore::outputLevel(ledLevelType _level) {
+    return gammaLevel(_level);
+}
+#endif
+
+#ifdef FF_LED_HARDWARE_FADE
+    #include "esp32-hal-periman.h"
+    #include "driver/ledc.h"
+#endif
+
+/*!
+
+	\brief	State machine constructor
+
+	Initialize the state machine
+
+	\param[in]	_initialLevel: LED level (0-FF_LED_MAX_LEVEL) at startup
+	\return	none
+
+*/
+FF_LEDCore::FF_LEDCore(ledLevelType _initialLevel) {
+    ledOnDelay = 0;                             // Union and bit fields have no default values
+    ledOffDelay = 0;
+    ledWaitDelay = 0;
+    ledDelay = 0;
+    ledLastTimeChanged = 0;
+    ledBlinksNeeded = 0;
+    ledBlinksDone = 0;
+    ledMinLevel = 0;
+    ledMaxLevel = FF_LED_MAX_LEVEL;
+    ledIncrease = false;
+    ledPulseIncrement = 0;
+    ledLevel = _initialLevel;
+    ledMode = fixed;
+}
 
 /*!
 
@@ -15,44 +275,134 @@
 
 	\param[in]	_ledPin: pin number where LED is connected to 
 	\param[in]	_isinverted: LED inverted (turned on when pin level is low)? (default = false)
-	\param[in]	_initialLevel: LED level (0-255) at startup (default = 0)
+	\param[in]	_initialLevel: LED level (0-FF_LED_MAX_LEVEL) at startup (default = 0)
 	\return	none
 
 */
-FF_LED::FF_LED(uint8_t _ledPin, bool _isinverted, uint8_t _initialLevel) {
+FF_LED::FF_LED(uint8_t _ledPin, bool _isinverted, ledLevelType _initialLevel) : FF_LEDCore(_initialLevel) {
     ledPin = _ledPin;
     ledInverted = _isinverted;
-    ledLevel = _initialLevel;
-    ledMode = fixed;
+    #ifdef FF_LED_COMPACT
+        ledOutput = 0;
+        ledOutputValid = false;
+        ledWritesHeld = false;
+        ledWritePending = false;
+    #endif
+}
+
+/*!
+
+	\brief	Class constructor for LED connected to an output driver
+
+	Initialize the class, LED being connected to a driver channel (shift register, PWM chip...)
+
+	\param[in]	_output: output driver where LED is connected to
+	\param[in]	_channel: driver channel where LED is connected to
+	\param[in]	_isinverted: LED inverted (turned on when output level is low)? (default = false)
+	\param[in]	_initialLevel: LED level (0-FF_LED_MAX_LEVEL) at startup (default = 0)
+	\return	none
+
+*/
+FF_LED::FF_LED(FF_LEDOutput *_output, uint8_t _channel, bool _isinverted, ledLevelType _initialLevel) : FF_LED(_channel, _isinverted, _initialLevel) {
+    ledDriver = _output;
 }
 
 FF_LED::~FF_LED(){
-    pinMode(ledPin, INPUT);                     // Set pin mode to input (release it)
+    if (!ledDriver) {
+        pinMode(ledPin, INPUT);                 // Set pin mode to input (release it)
+    }
 }
 
 /*!
 
 	\brief	Set LED level
 
-	Set LED level and time to stay at this level
+	Set LED level and time to stay at this level (pin is written by caller)
+
+	\param[in]	_level: LED level (0-FF_LED_MAX_LEVEL) to set
+	\param[in]	_delay: time to stay at this level (in ticks)
+	\return	none
+
+*/
+void FF_LEDCore::setLed(ledLevelType _level, ledTimeType _delay) {
+    setLed(_level, _delay, toTicks(millis()));
+}
+
+/*!
+
+	\brief	Set LED level at a given time
 
-	\param[in]	_level: LED level (0-255) to set
-	\param[in]	_delay: time to stay at this level (in ms)
+	Set LED level and time to stay at this level, using an already read clock value
+
+	\param[in]	_level: LED level (0-FF_LED_MAX_LEVEL) to set
+	\param[in]	_delay: time to stay at this level (in ticks)
+	\param[in]	_now: current time (in ticks, as returned by toTicks())
 	\return	none
 
 */
-void FF_LED::setLed(uint8_t _level, unsigned long _delay) {
+void FF_LED_IRAM_ATTR FF_LEDCore::setLed(ledLevelType _level, ledTimeType _delay, ledTimeType _now) {
     //Serial.printf(PSTR("setLed: level:%d, delay: %u, blinks: %d/%d\n"), _level, _delay, ledBlinksDone, ledBlinksNeeded);
     ledLevel = _level;                          // Save current LED level
     ledDelay = _delay;                          // Save delay before next change
-    ledLastTimeChanged = millis();              // Save change time
-    if (ledLevel == 0) {
-        digitalWrite(ledPin, ledInverted ? 255 : 0);
-    } else if (ledLevel == 255) {
-        digitalWrite(ledPin, ledInverted ? 0 : 255);
-    } else {
-        analogWrite(ledPin, ledInverted ? 255 - ledLevel : ledLevel);
+    ledLastTimeChanged = _now;                  // Save change time
+}
+
+/*!
+
+	\brief	Write LED level
+
+	Write current LED level to pin
+
+	\return	none
+
+*/
+void FF_LED_IRAM_ATTR FF_LED::writeLed(void) {
+    if (ledWritesHeld) {
+        ledWritePending = true;                 // Written once at end of frame
+        return;
+    }
+    ledLevelType output = outputLevel(ledLevel); // Apply brightness curve
+    #ifdef FF_LED_BRIGHTNESS
+        ledWrittenSerial = ledBrightnessSerial; // Output is up to date with global brightness
+    #endif
+    #ifdef FF_LED_POWER_BUDGET
+        if (ledGroup) {
+            ledGroup->powerDemand(this, output); // Count requested output in group's total
+            output = ledGroup->powerScale(output);
+        }
+    #endif
+    #ifdef FF_LED_HARDWARE_FADE
+        if (ledFading) {                        // Stop running fade before writing new level
+            stopFade();
+        }
+    #endif
+    if (ledOutputValid && output == ledOutput) {
+        ledWritesAvoided++;                     // Pin already has this value
+        return;
+    }
+    ledOutput = output;
+    ledOutputValid = true;
+    #ifdef FF_LED_STATS
+        ledStats.writes++;
+    #endif
+    if (ledDriver) {                            // Stage value in driver
+        ledDriver->write(ledPin, ledInverted ? FF_LED_MAX_LEVEL - output : output);
+        if (!ledGroup) {                        // Group flushes drivers once per loop
+            ledDriver->flush();
+        }
+        return;
     }
+    #ifdef FF_LED_HARDWARE_FADE
+        ledcWrite(ledPin, ledInverted ? FF_LED_MAX_LEVEL - output : output); // Keep pin attached to LEDC
+    #else
+        if (output == 0) {
+            digitalWrite(ledPin, ledInverted ? HIGH : LOW);
+        } else if (output == FF_LED_MAX_LEVEL) {
+            digitalWrite(ledPin, ledInverted ? LOW : HIGH);
+        } else {
+            analogWrite(ledPin, ledInverted ? FF_LED_MAX_LEVEL - output : output);
+        }
+    #endif
 }
 
 /*!
@@ -62,20 +412,20 @@ void FF_LED::setLed(uint8_t _level, unsigned long _delay) {
 	Start LED blinking sequence
 
 	\param[in]	_blinkCount: number of  time to blink LED
-	\param[in]	_onTime: time to light the LED (in ms)
-	\param[in]	_offTime: time to keep LED off (in ms)
-	\param[in]	_waitTime: time to wait after the blink sequence of _blinkCount
-	\param[in]	_minLevel: minimum (OFF) LED level (0-255, default to 0)
-	\param[in]	_maxLevel: maximum (ON) LED level (0-255, default to 255)
+	\param[in]	_onTime: time to light the LED (in ms, up to FF_LED_MAX_DELAY)
+	\param[in]	_offTime: time to keep LED off (in ms, up to FF_LED_MAX_DELAY)
+	\param[in]	_waitTime: time to wait after the blink sequence of _blinkCount (in ms, up to FF_LED_MAX_DELAY)
+	\param[in]	_minLevel: minimum (OFF) LED level (0-FF_LED_MAX_LEVEL, default to 0)
+	\param[in]	_maxLevel: maximum (ON) LED level (0-FF_LED_MAX_LEVEL, default to FF_LED_MAX_LEVEL)
 	\return	none
 
 */
-void FF_LED::setBlink(uint8_t _blinkCount, unsigned long _onTime, unsigned long _offTime, unsigned long _waitTime, uint8_t _minLevel, uint8_t _maxLevel) {
+void FF_LEDCore::setBlink(uint8_t _blinkCount, unsigned long _onTime, unsigned long _offTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel) {
     //Serial.printf(PSTR("setBlink count:%d, on:%u, off:%u, wait:%u, min:%d, max: %d\n"), _blinkCount, _onTime, _offTime, _waitTime, _minLevel, _maxLevel);
     ledBlinksNeeded = _blinkCount;              // Set needed blinks count
-    ledOnDelay = _onTime;
-    ledOffDelay = _offTime;
-    ledWaitDelay = _waitTime;
+    ledOnDelay = toDelay(_onTime);
+    ledOffDelay = toDelay(_offTime);
+    ledWaitDelay = toDelay(_waitTime);
     ledMinLevel = _minLevel;
     ledMaxLevel = _maxLevel;
     ledBlinksDone = 0;                          // Clear done count
@@ -93,15 +443,15 @@ void FF_LED::setBlink(uint8_t _blinkCount, unsigned long _onTime, unsigned long
 
 	Set LED permanent level
 
-	\param[in]	_level: LED level to set (0-255)
+	\param[in]	_level: LED level to set (0-FF_LED_MAX_LEVEL)
 	\return	none
 
 */
-void FF_LED::setFixed(uint8_t _level) {
+void FF_LEDCore::setFixed(ledLevelType _level) {
     //Serial.printf(PSTR("setFixed level:%d\n"), _level);
     ledLevel = _level;
     ledMode = fixed;
-    setLed(ledLevel, FF_LED_WAIT_FOR_EVER);
+    setLed(ledLevel, ledForEver);
 }
 
 /*!
@@ -111,22 +461,22 @@ void FF_LED::setFixed(uint8_t _level) {
 	Start LED blinking sequence
 
 	\param[in]	_increase: set to true to start from _minLevel, false to start from _maxLevel
-	\param[in]	_upTime: time to wait between 2 increases (in ms)
-	\param[in]	_downTime: time to wait between 2 decreases (in ms)
-	\param[in]	_waitTime: time to wait after one pulse sequence
-	\param[in]	_minLevel: minimum LED level (0-255, default to 0)
-	\param[in]	_maxLevel: maximum LED level (0-255, default to 255)
+	\param[in]	_upTime: time to wait between 2 increases (in ms, up to FF_LED_MAX_DELAY)
+	\param[in]	_downTime: time to wait between 2 decreases (in ms, up to FF_LED_MAX_DELAY)
+	\param[in]	_waitTime: time to wait after one pulse sequence (in ms, up to FF_LED_MAX_DELAY)
+	\param[in]	_minLevel: minimum LED level (0-FF_LED_MAX_LEVEL, default to 0)
+	\param[in]	_maxLevel: maximum LED level (0-FF_LED_MAX_LEVEL, default to FF_LED_MAX_LEVEL)
 	\return	none
 
 */
-void FF_LED::setPulse(bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, uint8_t _minLevel, uint8_t _maxLevel) {
+void FF_LEDCore::setPulse(bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel) {
     //Serial.printf(PSTR("setPulse increase:%d, up:%u, down:%u, wait:%u, min:%d, max: %d\n"), _increase, _upTime, _downTime, _waitTime, _minLevel, _maxLevel);
-    ledIncrease = _increase;                               // Save given parameters
+    ledIncrease = _increase;                                // Save given parameters
     ledMinLevel = _minLevel;
     ledMaxLevel = _maxLevel;
-    ledOnDelay = _upTime;
-    ledOffDelay = _downTime;
-    ledWaitDelay = _waitTime;
+    ledOnDelay = toDelay(_upTime);
+    ledOffDelay = toDelay(_downTime);
+    ledWaitDelay = toDelay(_waitTime);
     ledMode = pulse;
     if (ledIncrease) {
         ledPulseIncrement = 1;
@@ -140,6 +490,443 @@ void FF_LED::setPulse(bool _increase, unsigned long _upTime, unsigned long _down
     setLed(ledLevel, ledDelay);                             // Start pulsing
 }
 
+/*!
+
+	\brief	Set LED continous time based pulse
+
+	Start LED pulse sequence where level is computed from time elapsed since cycle start,
+	instead of one step each delay. Late loop() calls are caught up, and cycle time is exactly
+	_upTime + _downTime + _waitTime.
+
+	\param[in]	_increase: set to true to start from _minLevel, false to start from _maxLevel
+	\param[in]	_upTime: total time to go from _minLevel to _maxLevel (in ms, up to FF_LED_MAX_DELAY)
+	\param[in]	_downTime: total time to go from _maxLevel to _minLevel (in ms, up to FF_LED_MAX_DELAY)
+	\param[in]	_waitTime: time to wait after one pulse sequence (in ms, up to FF_LED_MAX_DELAY)
+	\param[in]	_minLevel: minimum LED level (0-FF_LED_MAX_LEVEL, default to 0)
+	\param[in]	_maxLevel: maximum LED level (0-FF_LED_MAX_LEVEL, default to FF_LED_MAX_LEVEL)
+	\return	none
+
+*/
+void FF_LEDCore::setTimedPulse(bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel) {
+    //Serial.printf(PSTR("setTimedPulse increase:%d, up:%u, down:%u, wait:%u, min:%d, max: %d\n"), _increase, _upTime, _downTime, _waitTime, _minLevel, _maxLevel);
+    ledIncrease = _increase;                                // Save given parameters
+    ledMinLevel = _minLevel;
+    ledMaxLevel = _maxLevel;
+    ledOnDelay = toDelay(_upTime);
+    ledOffDelay = toDelay(_downTime);
+    ledWaitDelay = toDelay(_waitTime);
+    ledMode = timedPulse;
+    ledCycleStart = toTicks(millis());                      // Cycle starts now
+    loopTimedPulse(ledCycleStart);                          // Set initial level
+}
+
+/*!
+
+	\brief	Play a sequence of steps
+
+	Start playing a table of steps, each one holding a level or ramping linearly from previous level
+	(first ramp starts from current LED level). Table is usually a constant in flash:
+
+		static const FF_LED::ledStepType alertSteps[] FF_LED_SEQUENCE_ATTR = {
+			{FF_LED_MAX_LEVEL, 100, FF_LED::hold}, {0, 100, FF_LED::hold},
+			{FF_LED_MAX_LEVEL, 100, FF_LED::hold}, {0, 500, FF_LED::hold},
+			{FF_LED_MAX_LEVEL, 1000, FF_LED::linear}, {0, 1000, FF_LED::linear}};
+		led.setSequence(alertSteps, 6);
+
+	As with time based pulse, late loop() calls are caught up, so sequence duration is exact.
+
+	\param[in]	_steps: steps table (declared with FF_LED_SEQUENCE_ATTR, should stay valid while played)
+	\param[in]	_stepCount: count of steps in table
+	\param[in]	_repeat: restart sequence after last step (else keep last level)
+	\return	none
+
+*/
+void FF_LEDCore::setSequence(const ledStepType *_steps, uint8_t _stepCount, bool _repeat) {
+    //Serial.printf(PSTR("setSequence steps:%d, repeat:%d\n"), _stepCount, _repeat);
+    if (!_steps || !_stepCount) {               // Nothing to play
+        setFixed(ledLevel);
+        return;
+    }
+    ledSteps = _steps;
+    ledStepCount = _stepCount;
+    ledStepIndex = 0;
+    ledIncrease = _repeat;
+    ledMinLevel = ledLevel;                     // First ramp starts from current level
+    ledMode = sequence;
+    ledStepStart = toTicks(millis());           // First step starts now
+    loopSequence(ledStepStart);                 // Set initial level
+}
+
+/*!
+
+	\brief	Set LED to fixed level
+
+	Set LED permanent level
+
+	\param[in]	_level: LED level to set (0-FF_LED_MAX_LEVEL)
+	\return	none
+
+*/
+void FF_LED::setFixed(ledLevelType _level) {
+    FF_LED_ENTER_CRITICAL();                    // Protect state against timer driven loop
+    ledLevelType previousLevel = ledLevel;
+    FF_LEDCore::setFixed(_level);
+    ledCyclesLeft = 0;
+    effectChanged(previousLevel);
+    FF_LED_EXIT_CRITICAL();
+}
+
+/*!
+
+	\brief	Set LED blink count
+
+	Start LED blinking sequence (see FF_LEDCore::setBlink()), repeated for ever or a given count of times
+
+	\param[in]	_cycleCount: count of blink sequences before LED stops (0 to repeat for ever, 1 for one-shot, default to 0)
+	\param[in]	_finalLevel: LED level kept once last sequence ended (default to 0)
+	\return	none
+
+*/
+void FF_LED::setBlink(uint8_t _blinkCount, unsigned long _onTime, unsigned long _offTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel, uint8_t _cycleCount, ledLevelType _finalLevel) {
+    FF_LED_ENTER_CRITICAL();                    // Protect state against timer driven loop
+    ledLevelType previousLevel = ledLevel;
+    FF_LEDCore::setBlink(_blinkCount, _onTime, _offTime, _waitTime, _minLevel, _maxLevel);
+    ledCyclesLeft = _cycleCount;
+    ledFinalLevel = _finalLevel;
+    effectChanged(previousLevel);
+    FF_LED_EXIT_CRITICAL();
+}
+
+/*!
+
+	\brief	Set LED continous pulse
+
+	Start LED pulse sequence (see FF_LEDCore::setPulse()), repeated for ever or a given count of times
+
+	\param[in]	_cycleCount: count of pulses before LED stops (0 to repeat for ever, 1 for one-shot, default to 0)
+	\param[in]	_finalLevel: LED level kept once last pulse ended (default to 0)
+	\return	none
+
+*/
+void FF_LED::setPulse(bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel, uint8_t _cycleCount, ledLevelType _finalLevel) {
+    FF_LED_ENTER_CRITICAL();                    // Protect state against timer driven loop
+    ledLevelType previousLevel = ledLevel;
+    FF_LEDCore::setPulse(_increase, _upTime, _downTime, _waitTime, _minLevel, _maxLevel);
+    ledCyclesLeft = _cycleCount;
+    ledFinalLevel = _finalLevel;
+    effectChanged(previousLevel);
+    FF_LED_EXIT_CRITICAL();
+}
+
+/*!
+
+	\brief	Set LED continous time based pulse
+
+	Start LED time based pulse sequence (see FF_LEDCore::setTimedPulse()), repeated for ever or a given count of times
+
+	\param[in]	_cycleCount: count of pulses before LED stops (0 to repeat for ever, 1 for one-shot, default to 0)
+	\param[in]	_finalLevel: LED level kept once last pulse ended (default to 0)
+	\return	none
+
+*/
+void FF_LED::setTimedPulse(bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel, uint8_t _cycleCount, ledLevelType _finalLevel) {
+    FF_LED_ENTER_CRITICAL();                    // Protect state against timer driven loop
+    ledLevelType previousLevel = ledLevel;
+    FF_LEDCore::setTimedPulse(_increase, _upTime, _downTime, _waitTime, _minLevel, _maxLevel);
+    ledCyclesLeft = _cycleCount;
+    ledFinalLevel = _finalLevel;
+    effectChanged(previousLevel);
+    FF_LED_EXIT_CRITICAL();
+}
+
+/*!
+
+	\brief	Play a sequence of steps
+
+	Start playing a table of steps (see FF_LEDCore::setSequence())
+
+	\return	none
+
+*/
+void FF_LED::setSequence(const ledStepType *_steps, uint8_t _stepCount, bool _repeat) {
+    FF_LED_ENTER_CRITICAL();                    // Protect state against timer driven loop
+    ledLevelType previousLevel = ledLevel;
+    FF_LEDCore::setSequence(_steps, _stepCount, _repeat);
+    ledCyclesLeft = 0;
+    effectChanged(previousLevel);
+    FF_LED_EXIT_CRITICAL();
+}
+
+#ifdef FF_LED_TRANSITIONS
+/*!
+
+	\brief	Set transition time
+
+	Set time used by next setFixed(), setBlink(), setPulse(), setTimedPulse() and setSequence() calls
+	to crossfade from current level to first level of new effect. New effect starts at end of transition.
+
+	\param[in]	_transitionTime: transition time (in ms, 0 to switch instantly)
+	\return	none
+
+*/
+void FF_LED::setTransition(unsigned long _transitionTime) {
+    FF_LED_ENTER_CRITICAL();
+    ledTransitionTime = toDelay(_transitionTime);
+    FF_LED_EXIT_CRITICAL();
+}
+#endif
+
+#ifdef FF_LED_CALLBACKS
+/*!
+
+	\brief	Set effect events callback
+
+	Set function called by loop() when some effect events occur, so that sketch can chain indications
+	without polling LED state:
+		- ledCycleEnded: blink burst finished, pulse ended (wait started), timed pulse cycle or sequence ended,
+		- ledPeakReached: pulse reached maximum level,
+		- ledWaitStarted: wait period between 2 blink bursts (or 2 pulses) started,
+		- ledStateChanged: any state change.
+
+	Callback is called after new level is written, with events that occurred (restricted to requested ones).
+	It may set a new effect (on this LED or any other one). Timed pulse reports wait start only with a wait time.
+	Callbacks are not supported when group runs from a timer (FF_LED_TIMER_DRIVEN, see FF_LEDGroup::timerLoop()).
+
+	\param[in]	_callback: function to call (nullptr to remove callback)
+	\param[in]	_events: events (ledEventType bit mask) to signal (default to ledCycleEnded, ledPeakReached and ledWaitStarted)
+	\return	none
+
+*/
+void FF_LED::setCallback(ledCallbackType _callback, uint8_t _events) {
+    FF_LED_ENTER_CRITICAL();
+    ledCallback = _callback;
+    ledCallbackEvents = _events;
+    FF_LED_EXIT_CRITICAL();
+}
+#endif
+
+/*!
+
+	\brief	Apply effect change
+
+	Write new effect first level, or start a transition to it
+
+	\param[in]	_previousLevel: LED level before effect change
+	\return	none
+
+*/
+void FF_LED::effectChanged(ledLevelType _previousLevel) {
+    #ifdef FF_LED_TRANSITIONS
+        if (ledTransitionTime && ledTransitionTime != ledForEver && _previousLevel != ledLevel) {
+            startTransition(_previousLevel, ledLastTimeChanged);
+            groupChanged();
+            return;
+        }
+        ledTransiting = false;
+    #else
+        (void) _previousLevel;
+    #endif
+    writeLed();
+    groupChanged();
+}
+
+/*!
+
+	\brief	Signal change to group
+
+	Tell group (if any) that LED deadline changed
+
+	\return	none
+
+*/
+void FF_LED::groupChanged(void) {
+    if (ledGroup) {
+        ledGroup->ledChanged();
+    }
+}
+
+/*!
+
+	\brief	Return count of writes avoided
+
+	Return count of pin writes skipped because pin already had the requested value
+
+	\return	count of writes avoided since start
+
+*/
+unsigned long FF_LED::getWritesAvoided(void) {
+    return ledWritesAvoided;
+}
+
+/*!
+
+	\brief	Save effect state
+
+	Save running effect and its phase in a small binary snapshot (a few bytes, can be kept in RTC memory
+	across deep sleep or given to an OTA reboot). Times are saved relative to last state change, so that
+	snapshot doesn't depend on millis(). A running transition is saved as ended.
+
+	Sequence steps table is not saved, as its address may change with firmware: give it to restoreState().
+
+		RTC_DATA_ATTR FF_LED::ledStateType statusState;
+		statusLed.saveState(&statusState);      // Before deep sleep
+		statusLed.restoreState(&statusState);   // After wake up, in setup(), after begin()
+
+	\param[out]	_state: snapshot to fill
+	\return	none
+
+*/
+void FF_LED::saveState(ledStateType *_state) {
+    FF_LED_ENTER_CRITICAL();                    // Protect state against timer driven loop
+    ledTimeType now = toTicks(millis());
+    ledTimeType lastTime = ledLastTimeChanged;
+    ledTimeType delay = ledDelay;
+    ledLevelType level = ledLevel;
+    ledTimeType start = lastTime;
+    if (ledMode == timedPulse) {
+        start = ledCycleStart;
+    } else if (ledMode == sequence) {
+        start = ledStepStart;
+    }
+    #ifdef FF_LED_TRANSITIONS
+        if (ledTransiting) {                    // New effect starts now
+            start += now - ledTransitionStart;
+            lastTime = now;
+            delay = ledTransitionDelay;
+            level = ledTransitionTo;
+        }
+    #endif
+    _state->delay = delay;
+    _state->elapsed = now - lastTime;
+    _state->phase = lastTime - start;
+    _state->level = level;
+    _state->minLevel = ledMinLevel;
+    _state->maxLevel = ledMaxLevel;
+    _state->finalLevel = ledFinalLevel;
+    _state->flags = ledMode | (ledIncrease ? 0x08 : 0) | (((ledPulseIncrement + 1) & 0x03) << 4);
+    _state->cyclesLeft = ledCyclesLeft;
+    _state->count = 0;
+    _state->counter = 0;
+    if (ledMode == sequence) {                  // Delays share memory with sequence
+        _state->onDelay = 0;
+        _state->offDelay = 0;
+        _state->waitDelay = 0;
+        _state->count = ledStepCount;
+        _state->counter = ledStepIndex;
+    } else {
+        _state->onDelay = ledOnDelay;
+        _state->offDelay = ledOffDelay;
+        _state->waitDelay = ledWaitDelay;
+        if (ledMode == blink) {
+            _state->count = ledBlinksNeeded;
+            _state->counter = ledBlinksDone;
+        }
+    }
+    FF_LED_EXIT_CRITICAL();
+}
+
+/*!
+
+	\brief	Restore effect state
+
+	Resume effect saved by saveState() where it was saved (same level, same time left in current state),
+	then write LED. Transition time doesn't apply.
+
+	\param[in]	_state: snapshot to restore
+	\param[in]	_steps: sequence steps table (sequence mode only, default to table of LED's running sequence)
+	\return	true if state restored, false if snapshot is not valid (LED not changed)
+
+*/
+bool FF_LED::restoreState(const ledStateType *_state, const ledStepType *_steps) {
+    uint8_t mode = _state->flags & 0x07;
+    if (mode > sequence) {
+        return false;
+    }
+    FF_LED_ENTER_CRITICAL();
+    if (mode == sequence) {
+        if (!_steps && ledMode == sequence && ledStepCount == _state->count) {
+            _steps = ledSteps;                  // Sequence already set by sketch
+        }
+        if (!_steps || _state->counter >= _state->count) {
+            FF_LED_EXIT_CRITICAL();
+            return false;
+        }
+    }
+    ledTimeType now = toTicks(millis());
+    #ifdef FF_LED_TRANSITIONS
+        ledTransiting = false;
+    #endif
+    ledMode = (ledModedType) mode;
+    ledIncrease = (_state->flags & 0x08) != 0;
+    ledPulseIncrement = ((_state->flags >> 4) & 0x03) - 1;
+    ledLevel = _state->level;
+    ledMinLevel = _state->minLevel;
+    ledMaxLevel = _state->maxLevel;
+    ledDelay = _state->delay;
+    ledLastTimeChanged = now - _state->elapsed;
+    if (mode == sequence) {
+        ledSteps = _steps;
+        ledStepCount = _state->count;
+        ledStepIndex = _state->counter;
+        ledStepStart = ledLastTimeChanged - _state->phase;
+    } else {
+        ledOnDelay = _state->onDelay;
+        ledOffDelay = _state->offDelay;
+        ledWaitDelay = _state->waitDelay;
+        if (mode == blink) {
+            ledBlinksNeeded = _state->count;
+            ledBlinksDone = _state->counter;
+        } else if (mode == timedPulse) {
+            ledCycleStart = ledLastTimeChanged - _state->phase;
+        }
+    }
+    ledCyclesLeft = _state->cyclesLeft;
+    ledFinalLevel = _state->finalLevel;
+    writeLed();
+    groupChanged();                             // Group should compute its next change again
+    FF_LED_EXIT_CRITICAL();
+    return true;
+}
+
+#ifdef FF_LED_STATS
+/*!
+
+	\brief	Return instrumentation counters
+
+	Return counters updated since start (or last resetStats()): pin writes, state changes run by loop(),
+	completed cycles, and lateness of state changes (time between deadline and loop() call running it).
+
+	High lateness means that loop() is not called often enough. Crossfade transitions and
+	hardware fade ramps are not counted as state changes.
+
+	\return	copy of counters, with average lateness computed
+
+*/
+FF_LED::ledStatsType FF_LED::getStats(void) {
+    FF_LED_ENTER_CRITICAL();                    // Protect counters against timer driven loop
+    ledStatsType stats = ledStats;
+    if (stats.transitions) {
+        stats.averageLateness = ledLatenessTotal / stats.transitions;
+    }
+    FF_LED_EXIT_CRITICAL();
+    return stats;
+}
+
+/*!
+
+	\brief	Clear instrumentation counters
+
+	\return	none
+
+*/
+void FF_LED::resetStats(void) {
+    FF_LED_ENTER_CRITICAL();
+    ledStats = {0, 0, 0, 0, 0};
+    ledLatenessTotal = 0;
+    FF_LED_EXIT_CRITICAL();
+}
+#endif
+
 /*!
 
 	\brief	Start class
@@ -150,8 +937,47 @@ void FF_LED::setPulse(bool _increase, unsigned long _upTime, unsigned long _down
 
 */
 void FF_LED::begin(void) {
-    setLed(ledLevel, FF_LED_WAIT_FOR_EVER);     // Turn LED to initial state
-    pinMode(ledPin, OUTPUT);                    // Set pin mode to output
+    if (ledDriver) {                            // Driver is started by sketch, just write initial state
+        setLed(ledLevel, ledForEver);
+        writeLed();
+        return;
+    }
+    #ifdef FF_LED_HARDWARE_FADE
+        ledcAttach(ledPin, FF_LED_HARDWARE_FADE_FREQUENCY, FF_LED_LEVEL_BITS); // Attach pin to LEDC (this also sets pin mode)
+        setLed(ledLevel, ledForEver);           // Turn LED to initial state
+        writeLed();
+    #else
+        setResolution(ledPin);                  // Set PWM resolution
+        setLed(ledLevel, ledForEver);           // Turn LED to initial state
+        writeLed();
+        pinMode(ledPin, OUTPUT);                // Set pin mode to output
+    #endif
+}
+
+/*!
+
+	\brief	Set PWM resolution
+
+	Set analogWrite() resolution matching FF_LED_LEVEL_BITS (nothing to do with 8 bits)
+
+	\param[in]	_pin: pin where LED is connected to
+	\return	none
+
+*/
+void FF_LEDCore::setResolution(uint8_t _pin) {
+    #if FF_LED_LEVEL_BITS != 8
+        #if defined(ESP32) && defined(ESP_ARDUINO_VERSION_MAJOR) && (ESP_ARDUINO_VERSION_MAJOR >= 3)
+            analogWriteResolution(_pin, FF_LED_LEVEL_BITS); // Resolution is set by pin
+        #elif defined(ESP8266) || defined(ARDUINO_ARCH_RP2040)
+            (void) _pin;
+            analogWriteRange(FF_LED_MAX_LEVEL); // Set full scale value
+        #else
+            (void) _pin;
+            analogWriteResolution(FF_LED_LEVEL_BITS); // Set resolution for all pins
+        #endif
+    #else
+        (void) _pin;
+    #endif
 }
 
 /*!
@@ -160,50 +986,644 @@ void FF_LED::begin(void) {
 
 	Loop part of class. Should be called in loop().
 
+	Returned value may be used to sleep (using delay(), light sleep, vTaskDelay()...) until next change.
+
+	LEDs without deadline (fixed level, ended sequence...) return at once, without reading clock.
+	Other ones compare time elapsed since last change with their delay, which stays right when millis() wraps.
+
+	\return	time before next LED change (in ms), FF_LED_WAIT_FOR_EVER if LED never changes
+
+*/
+unsigned long FF_LED::loop(void) {
+    if (isIdle()) {
+        refreshOutput();
+        return FF_LED_WAIT_FOR_EVER;            // Nothing to do until a new effect is set
+    }
+    unsigned long now = millis();
+    loop(now);
+    return nextChangeIn(now);
+}
+
+/*!
+
+	\brief	Loop at a given time
+
+	Loop part of class, using an already read clock value
+
+	\param[in]	_now: current time (in ms, as returned by millis())
+	\return	none
+
+*/
+void FF_LED_IRAM_ATTR FF_LED::loop(unsigned long _now) {
+    refreshOutput();
+    #ifdef FF_LED_TRANSITIONS
+        if (ledTransiting && !loopTransition(toTicks(_now))) {
+            return;                             // Transition still running
+        }
+    #endif
+    #ifdef FF_LED_HARDWARE_FADE
+        if (ledMode == pulse && !ledDriver) {   // Pulse ramps are run by LEDC
+            ledTimeType now = toTicks(_now);
+            if ((ledFading && ledFadeDone) || (ledTimeType) (now - ledLastTimeChanged) > ledDelay) {
+                uint8_t events = loopHardwarePulse(now);
+                if ((events & ledCycleEnded) && cycleEnded(now)) {
+                    writeLed();
+                }
+                signalEvents(events);
+            }
+            return;
+        }
+    #endif
+    #ifdef FF_LED_STATS
+        ledTimeType deadline = ledLastTimeChanged + ledDelay; // State changes when this time is exceeded
+    #endif
+    uint8_t events = FF_LEDCore::loop(_now);
+    if (events & ledCycleEnded) {
+        cycleEnded(toTicks(_now));
+    }
+    if (events) {                               // Write pin only if state changed
+        #ifdef FF_LED_STATS
+            unsigned long lateness = (unsigned long) (ledTimeType) (toTicks(_now) - deadline - 1) * FF_LED_TICK_MS;
+            ledStats.transitions++;
+            ledLatenessTotal += lateness;
+            if (lateness > ledStats.maxLateness) {
+                ledStats.maxLateness = lateness;
+            }
+            if (events & ledCycleEnded) {
+                ledStats.cycles++;
+            }
+        #endif
+        writeLed();
+        signalEvents(events);
+    }
+}
+
+/*!
+
+	\brief	Loop for a frame
+
+	Run all state changes due since last frame, each one at its own deadline (so that effect
+	timing doesn't depend on frame rate), then write LED once with its last level.
+	Hardware fades are run as in loop().
+
+	\param[in]	_now: current time (in ms, as returned by millis())
 	\return	none
 
 */
-void FF_LED::loop(void) {
+void FF_LED_IRAM_ATTR FF_LED::loopFrame(unsigned long _now) {
+    #ifdef FF_LED_HARDWARE_FADE
+        if (ledFading || (ledMode == pulse && !ledDriver)) {
+            loop(_now);
+            return;
+        }
+    #endif
+    ledWritesHeld = true;
+    for (uint8_t steps = 0; !isIdle(); steps++) {
+        ledTimeType elapsed = toTicks(_now) - ledLastTimeChanged;
+        if (elapsed <= ledDelay) {
+            break;                              // Next change is in a later frame
+        }
+        if (steps == 255) {                     // Too late to replay all changes, run last one now
+            loop(_now);
+            break;
+        }
+        ledTimeType lateness = elapsed - ledDelay - 1;
+        loop(_now - (_now % FF_LED_TICK_MS) - (unsigned long) lateness * FF_LED_TICK_MS); // At change deadline
+    }
+    ledWritesHeld = false;
+    if (ledWritePending) {
+        ledWritePending = false;
+        writeLed();
+    }
+    refreshOutput();
+}
+
+/*!
+
+	\brief	Count ended cycle
+
+	Count one cycle of a repeated effect, and settle to final level after last one. LED is then
+	idle, so that loop() doesn't cost anything anymore.
+
+	\param[in]	_now: current time (in ticks, as returned by toTicks())
+	\return	true if last cycle ended (LED set to final level, but not written)
+
+*/
+bool FF_LED_IRAM_ATTR FF_LED::cycleEnded(ledTimeType _now) {
+    if (!ledCyclesLeft || --ledCyclesLeft) {
+        return false;                           // Repeated for ever, or cycles left
+    }
+    ledMode = fixed;
+    setLed(ledFinalLevel, ledForEver, _now);
+    return true;
+}
+
+/*!
+
+	\brief	State machine loop
+
+	Run state machine at a given time (pin is written by caller)
+
+	\param[in]	_now: current time (in ms, as returned by millis())
+	\return	0 if nothing changed, else ledEventType bit mask (ledStateChanged, plus cycle end, peak or wait start)
+
+*/
+uint8_t FF_LED_IRAM_ATTR FF_LEDCore::loop(unsigned long _now) {
+    ledTimeType now = toTicks(_now);
     // Do we exceed wait delay for this level ?
-    if ((millis() - ledLastTimeChanged) > ledDelay) {
+    if ((ledTimeType) (now - ledLastTimeChanged) > ledDelay) {
+        uint8_t events = ledStateChanged;
         if (ledMode == blink) {                     // Mode is blink
             if (ledLevel == ledMaxLevel) {          // LED is on
                 ledBlinksDone++;                    // Increment blink count
-                setLed(ledMinLevel, ledOffDelay);   // Set LED off
+                setLed(ledMinLevel, ledOffDelay, now); // Set LED off
             } else {                                // Do we done all blinks?
                 if (ledBlinksDone >= ledBlinksNeeded) {
+                    events |= ledCycleEnded | ledWaitStarted;
                     ledBlinksDone = 0;              // Clear blink count
-                    setLed(ledMinLevel, ledWaitDelay); // Set LED off, wait for interval between 2 blinks sequences
+                    setLed(ledMinLevel, ledWaitDelay, now); // Set LED off, wait for interval between 2 blinks sequences
                 } else {
-                    setLed(ledMaxLevel, ledOnDelay);// Set LED on
+                    setLed(ledMaxLevel, ledOnDelay, now); // Set LED on
                 }
             }
         } else if (ledMode == pulse) {
             //Serial.printf(PSTR("level:%d, increment: %d\n"), ledLevel, ledPulseIncrement);
-            int16_t ledNewLevel = ledLevel + ledPulseIncrement;
+            int32_t ledNewLevel = (int32_t) ledLevel + ledPulseIncrement;
             if (ledPulseIncrement > 0) {                        // Are we increasing level?
                 if (ledNewLevel > ledMaxLevel) {
+                    events |= ledPeakReached;
                     if (ledIncrease) {                          // Is mode = increase?
-                        setLed(ledMaxLevel, ledOffDelay);       // Decrease level
+                        setLed(ledMaxLevel, ledOffDelay, now); // Decrease level
                     } else {
-                        setLed(ledMaxLevel, ledWaitDelay);      // Wait for interval between 2 pulse sequences
+                        events |= ledCycleEnded | ledWaitStarted;
+                        setLed(ledMaxLevel, ledWaitDelay, now); // Wait for interval between 2 pulse sequences
                     }
                     ledPulseIncrement = -1;                     // Revert way
                 } else {
-                    setLed((uint8_t) ledNewLevel, ledOnDelay);
+                    setLed((ledLevelType) ledNewLevel, ledOnDelay, now);
                 }
             } else {                                            // We are decreasing level
                 if (ledNewLevel < ledMinLevel) {
                     if (!ledIncrease) {                         // Is mode = decrease?
-                        setLed(ledMinLevel, ledOnDelay);        // Increase level
+                        setLed(ledMinLevel, ledOnDelay, now); // Increase level
                     } else {
-                        setLed(ledMinLevel, ledWaitDelay);      // Wait for interval between 2 pulse sequences
+                        events |= ledCycleEnded | ledWaitStarted;
+                        setLed(ledMinLevel, ledWaitDelay, now); // Wait for interval between 2 pulse sequences
                     }
                     ledPulseIncrement = 1;                      // Revert way
                 } else {
-                    setLed((uint8_t) ledNewLevel, ledOffDelay);
+                    setLed((ledLevelType) ledNewLevel, ledOffDelay, now);
                 }
             }
+        } else if (ledMode == timedPulse) {
+            events |= loopTimedPulse(now);
+        } else if (ledMode == sequence) {
+            events |= loopSequence(now);
+        }
+        return events;
+    }
+    return 0;
+}
+
+/*!
+
+	\brief	Time until next change
+
+	Compute time remaining before LED level changes
+
+	\return	time before next change (in ms), 0 if change is due, FF_LED_WAIT_FOR_EVER if LED never changes
+
+*/
+unsigned long FF_LED::nextChangeIn(void) {
+    if (isIdle()) {
+        return FF_LED_WAIT_FOR_EVER;
+    }
+    return nextChangeIn(millis());
+}
+
+/*!
+
+	\brief	Time until next change at a given time
+
+	Compute time remaining before LED level changes, taking transition into account
+
+	\param[in]	_now: current time (in ms, as returned by millis())
+	\return	time before next change (in ms), 0 if change is due, FF_LED_WAIT_FOR_EVER if LED never changes
+
+*/
+unsigned long FF_LED_IRAM_ATTR FF_LED::nextChangeIn(unsigned long _now) {
+    #ifdef FF_LED_TRANSITIONS
+        if (ledTransiting) {                    // Transition ends (or steps) even if new effect is fixed
+            ledTimeType elapsed = toTicks(_now) - ledLastTimeChanged;
+            if (elapsed > ledDelay) {
+                return 0;
+            }
+            return ((unsigned long) (ledDelay - elapsed) + 1) * FF_LED_TICK_MS - (_now % FF_LED_TICK_MS);
+        }
+    #endif
+    return FF_LEDCore::nextChangeIn(_now);
+}
+
+/*!
+
+	\brief	Time until next change at a given time
+
+	Compute time remaining before LED level changes, using an already read clock value
+
+	\param[in]	_now: current time (in ms, as returned by millis())
+	\return	time before next change (in ms), 0 if change is due, FF_LED_WAIT_FOR_EVER if LED never changes
+
+*/
+unsigned long FF_LED_IRAM_ATTR FF_LEDCore::nextChangeIn(unsigned long _now) {
+    if (ledMode == fixed || ledDelay == ledForEver) {
+        return FF_LED_WAIT_FOR_EVER;            // Nothing will ever change
+    }
+    ledTimeType elapsed = toTicks(_now) - ledLastTimeChanged;
+    if (elapsed > ledDelay) {
+        return 0;                               // Change is due
+    }
+    // Change occurs when elapsed ticks exceed delay, remove part of current tick already elapsed
+    return ((unsigned long) (ledDelay - elapsed) + 1) * FF_LED_TICK_MS - (_now % FF_LED_TICK_MS);
+}
+
+/*!
+
+	\brief	Compute ramp step
+
+	Compute step reached at a given time of a linear ramp, and time of next step
+
+	\param[in]	_time: time elapsed since ramp start (in ms, lower than _duration)
+	\param[in]	_duration: ramp duration (in ms)
+	\param[in]	_steps: count of steps in ramp
+	\param[out]	_nextTime: time of next step since ramp start (in ms)
+	\return	step reached (0 to _steps - 1)
+
+*/
+static FF_LEDCore::ledLevelType FF_LED_IRAM_ATTR rampStep(unsigned long _time, unsigned long _duration, FF_LEDCore::ledLevelType _steps, unsigned long *_nextTime) {
+    if (!_steps) {                                          // Flat ramp
+        *_nextTime = _duration;
+        return 0;
+    }
+    uint8_t shift = 0;
+    unsigned long duration = _duration;
+    unsigned long limit = (0xFFFFFFFFUL - _steps) / _steps;
+    while (duration > limit) {                              // Keep products in 32 bits for long ramps
+        duration >>= 1;
+        shift++;
+    }
+    FF_LEDCore::ledLevelType step = ((_time >> shift) * _steps) / duration;
+    // Next step starts when time * steps reaches (step + 1) * duration
+    *_nextTime = ((((step + 1) * duration) + _steps - 1) / _steps) << shift;
+    return step;
+}
+
+/*!
+
+	\brief	Loop for time based pulse
+
+	Compute LED level from time elapsed since cycle start, and delay until level changes again
+
+	\param[in]	_now: current time (in ticks, as returned by toTicks())
+	\return	ledEventType bit mask of cycle end, peak and wait start crossed since previous change (0 if none)
+
+*/
+uint8_t FF_LED_IRAM_ATTR FF_LEDCore::loopTimedPulse(ledTimeType _now) {
+    unsigned long firstTime = ledIncrease ? ledOnDelay : ledOffDelay;
+    unsigned long secondTime = ledIncrease ? ledOffDelay : ledOnDelay;
+    unsigned long cycleTime = firstTime + secondTime;
+    if (cycleTime < firstTime || cycleTime + ledWaitDelay < cycleTime || cycleTime + ledWaitDelay > ledForEver) {
+        cycleTime = ledForEver;                             // Overflow, clip cycle time
+    } else {
+        cycleTime += ledWaitDelay;
+    }
+    if (!cycleTime) {                                       // Nothing to pulse
+        setLed(ledIncrease ? ledMinLevel : ledMaxLevel, ledForEver, _now);
+        return 0;
+    }
+    uint8_t events = 0;
+    unsigned long elapsed = (ledTimeType) (_now - ledCycleStart);
+    unsigned long previous = (ledTimeType) (ledLastTimeChanged - ledCycleStart); // Time of previous change in cycle
+    if (elapsed >= cycleTime) {                             // Skip complete cycles missed
+        events = ledCycleEnded;
+        elapsed %= cycleTime;
+        ledCycleStart = _now - elapsed;
+        previous = 0;
+    }
+    unsigned long peakTime = ledIncrease ? firstTime : firstTime + secondTime;
+    if (previous < peakTime && elapsed >= peakTime) {
+        events |= ledPeakReached;
+    }
+    if (ledWaitDelay && previous < firstTime + secondTime && elapsed >= firstTime + secondTime) {
+        events |= ledWaitStarted;
+    }
+    ledLevelType steps = ledMaxLevel - ledMinLevel;
+    ledLevelType step;
+    unsigned long nextTime;
+    ledLevelType level;
+    if (elapsed < firstTime) {                              // First ramp
+        step = rampStep(elapsed, firstTime, steps, &nextTime);
+        level = ledIncrease ? ledMinLevel + step : ledMaxLevel - step;
+    } else if (elapsed - firstTime < secondTime) {          // Second ramp
+        step = rampStep(elapsed - firstTime, secondTime, steps, &nextTime);
+        nextTime += firstTime;
+        level = ledIncrease ? ledMaxLevel - step : ledMinLevel + step;
+    } else {                                                // Wait for interval between 2 pulse sequences
+        nextTime = cycleTime;
+        level = ledIncrease ? ledMinLevel : ledMaxLevel;
+    }
+    setLed(level, nextTime - elapsed - 1, _now);            // Change occurs when elapsed time exceeds delay
+    return events;
+}
+
+/*!
+
+	\brief	Loop for sequence
+
+	Skip ended steps, then compute LED level from time elapsed since current step start,
+	and delay until level changes again
+
+	\param[in]	_now: current time (in ticks, as returned by toTicks())
+	\return	ledCycleEnded if end of table was reached, else 0
+
+*/
+uint8_t FF_LED_IRAM_ATTR FF_LEDCore::loopSequence(ledTimeType _now) {
+    ledStepType step;
+    uint8_t emptySteps = 0;
+    uint8_t events = 0;
+    memcpy_P(&step, &ledSteps[ledStepIndex], sizeof(step));
+    ledTimeType duration = toDelay(step.duration);
+    while ((ledTimeType) (_now - ledStepStart) >= duration) { // Current step ended
+        ledMinLevel = step.level;               // Next ramp starts from this level
+        ledStepStart += duration;
+        emptySteps = duration ? 0 : emptySteps + 1;
+        if (++ledStepIndex >= ledStepCount) {   // End of table
+            if (!ledIncrease || emptySteps >= ledStepCount) { // No repeat (or nothing but empty steps)
+                ledMode = fixed;
+                setLed(step.level, ledForEver, _now);
+                return ledCycleEnded;
+            }
+            events = ledCycleEnded;
+            ledStepIndex = 0;
+        }
+        memcpy_P(&step, &ledSteps[ledStepIndex], sizeof(step));
+        duration = toDelay(step.duration);
+    }
+    unsigned long elapsed = (ledTimeType) (_now - ledStepStart);
+    unsigned long nextTime = duration;
+    ledLevelType level = step.level;
+    if (step.ramp == linear) {                  // Level moves from previous one
+        if (step.level >= ledMinLevel) {
+            level = ledMinLevel + rampStep(elapsed, duration, step.level - ledMinLevel, &nextTime);
+        } else {
+            level = ledMinLevel - rampStep(elapsed, duration, ledMinLevel - step.level, &nextTime);
+        }
+        if (nextTime > duration) {
+            nextTime = duration;
+        }
+    }
+    setLed(level, nextTime - elapsed - 1, _now); // Change occurs when elapsed time exceeds delay
+    return events;
+}
+
+#ifdef FF_LED_TRANSITIONS
+/*!
+
+	\brief	Start a transition
+
+	Save first level and delay of new effect, then ramp from previous level to it
+
+	\param[in]	_previousLevel: LED level before effect change
+	\param[in]	_now: current time (in ticks, as returned by toTicks())
+	\return	none
+
+*/
+void FF_LED::startTransition(ledLevelType _previousLevel, ledTimeType _now) {
+    ledTransitionTo = ledLevel;                 // Effect starts at end of transition
+    ledTransitionDelay = ledDelay;
+    ledTransitionFrom = _previousLevel;
+    ledTransitionStart = _now;
+    ledTransiting = true;
+    #ifdef FF_LED_HARDWARE_FADE
+        if (!ledDriver) {                       // Let LEDC fade engine run transition
+            if (ledFading) {
+                stopFade();
+            }
+            ledLevel = _previousLevel;
+            fadeTo(ledTransitionTo, ledTransitionTime, _now);
+            return;
+        }
+    #endif
+    loopTransition(_now);
+}
+
+/*!
+
+	\brief	Loop for transition
+
+	Compute LED level from time elapsed since transition start, then start new effect at transition end
+
+	\param[in]	_now: current time (in ticks, as returned by toTicks())
+	\return	true if transition ended (and effect should run), false if still running
+
+*/
+bool FF_LED_IRAM_ATTR FF_LED::loopTransition(ledTimeType _now) {
+    ledTimeType elapsed = _now - ledTransitionStart;
+    #ifdef FF_LED_HARDWARE_FADE
+        if (ledFading) {                        // Transition run by LEDC
+            if (!ledFadeDone && elapsed < ledTransitionTime) {
+                return false;
+            }
+            if (!ledFadeDone) {
+                stopFade();                     // Delay expired before fade end interrupt
+            }
+            ledFading = false;
+        }
+    #endif
+    if (elapsed < ledTransitionTime) {
+        unsigned long nextTime;
+        ledLevelType level;
+        if (ledTransitionTo >= ledTransitionFrom) {
+            level = ledTransitionFrom + rampStep(elapsed, ledTransitionTime, ledTransitionTo - ledTransitionFrom, &nextTime);
+        } else {
+            level = ledTransitionFrom - rampStep(elapsed, ledTransitionTime, ledTransitionFrom - ledTransitionTo, &nextTime);
+        }
+        if (nextTime > ledTransitionTime) {
+            nextTime = ledTransitionTime;
+        }
+        FF_LEDCore::setLed(level, nextTime - elapsed - 1, _now); // Change occurs when elapsed time exceeds delay
+        writeLed();
+        return false;
+    }
+    endTransition();
+    writeLed();
+    return true;
+}
+
+/*!
+
+	\brief	End transition
+
+	Start new effect, shifted by transition time (pin is written by caller)
+
+	\return	none
+
+*/
+void FF_LED_IRAM_ATTR FF_LED::endTransition(void) {
+    ledTransiting = false;
+    ledTimeType end = ledTransitionStart + ledTransitionTime;
+    FF_LEDCore::setLed(ledTransitionTo, ledTransitionDelay, end);
+    if (ledMode == timedPulse) {
+        ledCycleStart += ledTransitionTime;
+    } else if (ledMode == sequence) {
+        ledStepStart += ledTransitionTime;
+    }
+}
+#endif
+
+#ifdef FF_LED_HARDWARE_FADE
+/*!
+
+	\brief	Loop for pulse using hardware fade
+
+	Pulse state machine when LEDC fade engine runs the ramps: each ramp is one state,
+	instead of one state per level step. Called when fade ended or current delay expired.
+
+	\param[in]	_now: current time (in ticks, as returned by toTicks())
+	\return	ledEventType bit mask (same events as software pulse)
+
+*/
+uint8_t FF_LED::loopHardwarePulse(ledTimeType _now) {
+    if (ledFading && !ledFadeDone) {                        // Delay expired before fade end interrupt
+        stopFade();
+    }
+    ledFading = false;
+    if (ledPulseIncrement > 0) {                            // Are we increasing level?
+        if (ledLevel < ledMaxLevel) {
+            startFade(ledMaxLevel, ledOnDelay, _now);       // Ramp up to maximum
+            return ledStateChanged;
+        }
+        ledPulseIncrement = -1;                             // Revert way
+        if (ledIncrease) {                                  // Is mode = increase?
+            startFade(ledMinLevel, ledOffDelay, _now);      // Ramp down to minimum
+            return ledStateChanged | ledPeakReached;
+        }
+        setLed(ledMaxLevel, ledWaitDelay, _now);            // Wait for interval between 2 pulse sequences
+        writeLed();
+        return ledStateChanged | ledPeakReached | ledCycleEnded | ledWaitStarted;
+    }
+    if (ledLevel > ledMinLevel) {                           // We are decreasing level
+        startFade(ledMinLevel, ledOffDelay, _now);          // Ramp down to minimum
+        return ledStateChanged;
+    }
+    ledPulseIncrement = 1;                                  // Revert way
+    if (!ledIncrease) {                                     // Is mode = decrease?
+        startFade(ledMaxLevel, ledOnDelay, _now);           // Ramp up to maximum
+        return ledStateChanged;
+    }
+    setLed(ledMinLevel, ledWaitDelay, _now);                // Wait for interval between 2 pulse sequences
+    writeLed();
+    return ledStateChanged | ledCycleEnded | ledWaitStarted;
+}
+
+/*!
+
+	\brief	Start a hardware fade
+
+	Ask LEDC fade engine to go from current level to given level, taking the same time
+	as the software pulse would (one step delay per level)
+
+	\param[in]	_level: LED level (0-FF_LED_MAX_LEVEL) at end of fade
+	\param[in]	_stepDelay: time to stay at each intermediate level (in ticks)
+	\param[in]	_now: current time (in ticks, as returned by toTicks())
+	\return	none
+
+*/
+void FF_LED::startFade(ledLevelType _level, ledTimeType _stepDelay, ledTimeType _now) {
+    ledLevelType steps = (_level > ledLevel) ? _level - ledLevel : ledLevel - _level;
+    unsigned long fadeTime = (unsigned long) steps * _stepDelay; // In ticks
+    if (fadeTime >= ledForEver) {
+        fadeTime = ledForEver - 1;                          // Keep fade end as a valid delay
+    }
+    fadeTo(_level, fadeTime, _now);
+}
+
+/*!
+
+	\brief	Start a hardware fade of a given duration
+
+	Ask LEDC fade engine to go from current level to given level in a given time
+
+	\param[in]	_level: LED level (0-FF_LED_MAX_LEVEL) at end of fade
+	\param[in]	_fadeTime: fade duration (in ticks, lower than ledForEver)
+	\param[in]	_now: current time (in ticks, as returned by toTicks())
+	\return	none
+
+*/
+void FF_LED::fadeTo(ledLevelType _level, ledTimeType _fadeTime, ledTimeType _now) {
+    unsigned long fadeTime = _fadeTime;
+    if (!fadeTime) {
+        setLed(_level, 0, _now);                            // Nothing to fade
+        writeLed();
+        return;
+    }
+    ledFadeDone = false;
+    ledLevelType startOutput = outputLevel(ledLevel);       // Apply brightness curve to fade ends
+    ledLevelType endOutput = outputLevel(_level);
+    #ifdef FF_LED_POWER_BUDGET
+        if (ledGroup) {
+            ledGroup->powerDemand(this, endOutput);         // Count fade end in group's total
+            startOutput = ledGroup->powerScale(startOutput);
+            endOutput = ledGroup->powerScale(endOutput);
         }
+    #endif
+    ledFading = ledcFadeWithInterruptArg(ledPin,
+        ledInverted ? FF_LED_MAX_LEVEL - startOutput : startOutput,
+        ledInverted ? FF_LED_MAX_LEVEL - endOutput : endOutput,
+        fadeTime * FF_LED_TICK_MS, fadeDone, this);
+    if (!ledFading) {
+        setLed(_level, fadeTime, _now);                     // Fade refused, jump to end level
+        writeLed();
+        return;
+    }
+    ledLevel = _level;                                      // Level at end of fade
+    ledOutput = endOutput;
+    ledOutputValid = true;
+    #ifdef FF_LED_STATS
+        ledStats.writes++;
+    #endif
+    ledDelay = fadeTime;                                    // Fade end is also checked as a normal delay
+    ledLastTimeChanged = _now;
+}
+
+/*!
+
+	\brief	Stop a hardware fade
+
+	Stop running fade, leaving LED at its current level (ledcWrite would wait for fade end otherwise)
+
+	\return	none
+
+*/
+void FF_LED::stopFade(void) {
+    ledFading = false;
+    ledOutputValid = false;                                 // Fade stopped somewhere between its ends
+    ledc_channel_handle_t *bus = (ledc_channel_handle_t *) perimanGetPinBus(ledPin, ESP32_BUS_TYPE_LEDC);
+    if (bus) {
+        ledc_fade_stop((ledc_mode_t) (bus->channel / SOC_LEDC_CHANNEL_NUM), (ledc_channel_t) (bus->channel % SOC_LEDC_CHANNEL_NUM));
     }
 }
+
+/*!
+
+	\brief	Hardware fade end
+
+	Called from LEDC interrupt when fade ends, only sets a flag read by loop()
+
+	\param[in]	_led: FF_LED instance which started the fade
+	\return	none
+
+*/
+void ARDUINO_ISR_ATTR FF_LED::fadeDone(void *_led) {
+    ((FF_LED *) _led)->ledFadeDone = true;
+}
+#endif
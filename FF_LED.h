@@ -13,39 +13,375 @@
     #define FF_LED_h
     #include "Arduino.h"
 
+    // Uncomment next line to let ESP32 LEDC fade engine run pulse ramps (needs ESP32 Arduino core 3.x or later)
+    //#define FF_LED_HARDWARE_FADE
+    #ifndef FF_LED_HARDWARE_FADE_FREQUENCY
+        #define FF_LED_HARDWARE_FADE_FREQUENCY 5000             //!< PWM frequency used by hardware fade (in Hz)
+    #endif
+    #ifdef FF_LED_HARDWARE_FADE
+        #if !defined(ESP32) || !defined(ESP_ARDUINO_VERSION_MAJOR) || (ESP_ARDUINO_VERSION_MAJOR < 3)
+            #warning FF_LED_HARDWARE_FADE needs ESP32 Arduino core 3.x or later, using software pulse instead
+            #undef FF_LED_HARDWARE_FADE
+        #endif
+    #endif
+
+    // Set next value to 10, 12 or 16 to use higher PWM resolution (ESP8266, ESP32, RP2040...)
+    #ifndef FF_LED_LEVEL_BITS
+        #define FF_LED_LEVEL_BITS 8                             //!< Count of bits of LED levels (and PWM resolution)
+    #endif
+    #if FF_LED_LEVEL_BITS < 8 || FF_LED_LEVEL_BITS > 16
+        #error FF_LED_LEVEL_BITS should be between 8 and 16
+    #endif
+    #define FF_LED_MAX_LEVEL ((1UL << FF_LED_LEVEL_BITS) - 1)   //!< Maximum LED level (full scale)
+
+    #define FF_LED_GAMMA_NONE 0                                 //!< Linear output (LED level written as is)
+    #define FF_LED_GAMMA_22 1                                   //!< Gamma 2.2 corrected output
+    #define FF_LED_GAMMA_CIE 2                                  //!< CIE 1931 lightness corrected output
+    // Set next value to FF_LED_GAMMA_22 or FF_LED_GAMMA_CIE to get perceptual brightness curve
+    #ifndef FF_LED_GAMMA
+        #define FF_LED_GAMMA FF_LED_GAMMA_NONE                  //!< Brightness curve applied between LED level and PWM
+    #endif
+
+    // Uncomment next line to scale all LEDs with a global brightness (see FF_LEDCore::setBrightness(), 256 bytes of RAM with 8 bits levels)
+    //#define FF_LED_BRIGHTNESS
+
+    // Uncomment next line to run LED state machines from a timer (Ticker on ESP8266/ESP32, user's timer interrupt elsewhere)
+    //  (only for LEDs on pins switched fully on or off (digitalWrite()), without output driver nor callback: see FF_LEDGroup.cpp)
+    //#define FF_LED_TIMER_DRIVEN
+    #ifdef FF_LED_TIMER_DRIVEN
+        #ifdef FF_LED_HARDWARE_FADE
+            #error FF_LED_TIMER_DRIVEN and FF_LED_HARDWARE_FADE cannot be used together (LEDC fade calls may block)
+        #endif
+        #if defined(ESP32)
+            extern portMUX_TYPE ffLedMux;                       //!< Spinlock protecting LED states
+            #define FF_LED_ENTER_CRITICAL() portENTER_CRITICAL(&ffLedMux)
+            #define FF_LED_EXIT_CRITICAL() portEXIT_CRITICAL(&ffLedMux)
+            #define FF_LED_ENTER_CRITICAL_ISR() portENTER_CRITICAL_ISR(&ffLedMux)
+            #define FF_LED_EXIT_CRITICAL_ISR() portEXIT_CRITICAL_ISR(&ffLedMux)
+        #else
+            #define FF_LED_ENTER_CRITICAL() noInterrupts()
+            #define FF_LED_EXIT_CRITICAL() interrupts()
+            #define FF_LED_ENTER_CRITICAL_ISR()                 // Timer interrupt can't be interrupted by sketch
+            #define FF_LED_EXIT_CRITICAL_ISR()
+        #endif
+        #if defined(ESP32) || defined(ESP8266)
+            #define FF_LED_IRAM_ATTR IRAM_ATTR                  //!< Keep timer code in RAM (on definitions only, as section name changes at each use)
+        #endif
+    #else
+        #define FF_LED_ENTER_CRITICAL()
+        #define FF_LED_EXIT_CRITICAL()
+        #define FF_LED_ENTER_CRITICAL_ISR()
+        #define FF_LED_EXIT_CRITICAL_ISR()
+    #endif
+    #ifndef FF_LED_IRAM_ATTR
+        #define FF_LED_IRAM_ATTR
+    #endif
+
+    // Uncomment next line to use compact state (16 bits delays in FF_LED_TICK_MS units, packed flags)
+    //  Times given to setters (on, off, wait, up, down, steps, transitions) are then limited to
+    //  FF_LED_MAX_DELAY (65534 x FF_LED_TICK_MS ms, 65.5 s with 1 ms ticks): longer times are clamped to it
+    //  FF_LED_TICK_MS should be a power of 2 (1, 2, 4, 8...), so that 16 bits tick counter wraps with millis()
+    //#define FF_LED_COMPACT
+    #ifdef FF_LED_COMPACT
+        #ifndef FF_LED_TICK_MS
+            #define FF_LED_TICK_MS 1                            //!< Compact delays unit (in ms, max delay is 65534 units)
+        #endif
+        #if FF_LED_TICK_MS < 1 || FF_LED_TICK_MS > 65536 || (FF_LED_TICK_MS & (FF_LED_TICK_MS - 1))
+            #error FF_LED_TICK_MS should be a power of 2, as ticks would not wrap with millis() otherwise
+        #endif
+        #define FF_LED_MAX_DELAY (65534UL * FF_LED_TICK_MS)     //!< Longest time accepted by setters (in ms, longer ones are clamped)
+        #if UINTPTR_MAX > 0xFFFFFFFFUL
+            #define FF_LED_COMPACT_STATE_SIZE 32                //!< Size of compact FF_LEDCore with 64 bits pointers (host simulation)
+        #elif FF_LED_LEVEL_BITS > 8
+            #define FF_LED_COMPACT_STATE_SIZE 20                //!< Size of compact FF_LEDCore (checked at compile time)
+        #else
+            #define FF_LED_COMPACT_STATE_SIZE 16                //!< Size of compact FF_LEDCore (checked at compile time)
+        #endif
+    #else
+        #undef FF_LED_TICK_MS
+        #define FF_LED_TICK_MS 1                                //!< Delays are always in ms when not compact
+        #define FF_LED_MAX_DELAY (4294967294UL)                 //!< Longest time accepted by setters (in ms, longer ones are clamped)
+    #endif
+
+    // Uncomment next line to limit total drive of LEDs of each FF_LEDGroup (see FF_LEDGroup::setPowerBudget())
+    //#define FF_LED_POWER_BUDGET
+
+    // Uncomment next line to allow crossfade transitions between effects (see FF_LED::setTransition(), up to 16 more bytes per FF_LED)
+    //#define FF_LED_TRANSITIONS
+
+    // Uncomment next line to call a function on effect events (see FF_LED::setCallback(), up to 16 more bytes per FF_LED)
+    //#define FF_LED_CALLBACKS
+
+    // Uncomment next line to count writes, transitions, cycles and lateness of each FF_LED (see FF_LED::getStats())
+    //#define FF_LED_STATS
+
+    // Sequence tables are read from flash, except from ESP timer interrupts where flash can't be read
+    #if defined(FF_LED_TIMER_DRIVEN) && (defined(ESP32) || defined(ESP8266))
+        #define FF_LED_SEQUENCE_ATTR                            //!< Attribute of sequence tables (keep them in RAM)
+    #else
+        #define FF_LED_SEQUENCE_ATTR PROGMEM                    //!< Attribute of sequence tables (keep them in flash)
+    #endif
+
     #ifdef __cplusplus
         #define FF_LED_WAIT_FOR_EVER (4294967295)               //!< Everyyyyy long time (arond 50 days)
-        class FF_LED {
+        class FF_LEDGroup;
+        class FF_LEDOutput;
+        class FF_LEDCore {
+            /*!	\class FF_LEDCore
+                \brief LED effects state machine, shared by FF_LED and FF_LEDT (no pin handling here)
+            */
+            public:
+                #if FF_LED_LEVEL_BITS > 8
+                    typedef uint16_t ledLevelType;              //!< LED level definition
+                #else
+                    typedef uint8_t ledLevelType;               //!< LED level definition
+                #endif
+                enum ledModedType {fixed, blink, pulse, timedPulse, sequence}; //!< LED mode definition
+                enum ledRampType {hold, linear};                //!< Sequence step type (hold level, or linear ramp from previous level)
+                enum ledEventType {ledStateChanged = 1, ledCycleEnded = 2, ledPeakReached = 4, ledWaitStarted = 8}; //!< State machine events (bit mask returned by loop())
+                struct ledStepType {
+                    ledLevelType level;                         //!< Level to set (hold) or to reach at end of step (linear)
+                    uint32_t duration;                          //!< Step duration (in ms)
+                    uint8_t ramp;                               //!< Step type (ledRampType)
+                };
+                #ifdef FF_LED_COMPACT
+                    typedef uint16_t ledTimeType;               //!< Time and delay definition (in FF_LED_TICK_MS units)
+                #else
+                    typedef uint32_t ledTimeType;               //!< Time and delay definition (in ms, wraps with millis())
+                #endif
+                /*! \brief Has state machine no deadline (LED won't change until a new effect is set)? */
+                inline bool isIdle(void) {return ledDelay == ledForEver;}
+                #ifdef FF_LED_BRIGHTNESS
+                    static void setBrightness(ledLevelType _brightness);
+                    static ledLevelType getBrightness(void);
+                #endif
+            protected:
+                friend class FF_LEDBatch;                       // Batch shares time conversions and brightness curve
+                static const ledTimeType ledForEver = (ledTimeType) ~0UL; //!< Delay meaning "never change"
+                #ifdef FF_LED_COMPACT
+                    /*! \brief Convert millis() value to ticks */
+                    static inline ledTimeType toTicks(unsigned long _ms) {return (ledTimeType) (_ms / FF_LED_TICK_MS);}
+                    /*! \brief Convert a delay in ms to ticks, clamping it to FF_LED_MAX_DELAY (instead of wrapping) and keeping FF_LED_WAIT_FOR_EVER */
+                    static inline ledTimeType toDelay(unsigned long _ms) {
+                        return (_ms == FF_LED_WAIT_FOR_EVER) ? ledForEver : (_ms >= FF_LED_MAX_DELAY) ? (ledTimeType) (FF_LED_MAX_DELAY / FF_LED_TICK_MS) : (ledTimeType) (_ms / FF_LED_TICK_MS);
+                    }
+                #else
+                    /*! \brief Convert millis() value to ticks (same unit when not compact) */
+                    static inline ledTimeType toTicks(unsigned long _ms) {return (ledTimeType) _ms;}
+                    /*! \brief Convert a delay in ms to ticks (same unit when not compact, saturating where unsigned long is 64 bits) */
+                    static inline ledTimeType toDelay(unsigned long _ms) {return (_ms >= ledForEver) ? ledForEver : (ledTimeType) _ms;}
+                #endif
+                FF_LEDCore(ledLevelType _initialLevel);
+                void setFixed(ledLevelType _level);
+                void setBlink(uint8_t _blinkCount, unsigned long _onTime, unsigned long _offTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel);
+                void setPulse(bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel);
+                void setTimedPulse(bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel);
+                void setSequence(const ledStepType *_steps, uint8_t _stepCount, bool _repeat);
+                void setLed(ledLevelType _level, ledTimeType _delay);
+                void setLed(ledLevelType _level, ledTimeType _delay, ledTimeType _now);
+                uint8_t loop(unsigned long _now);
+                unsigned long nextChangeIn(unsigned long _now);
+                uint8_t loopTimedPulse(ledTimeType _now);
+                uint8_t loopSequence(ledTimeType _now);
+                static void setResolution(uint8_t _pin);
+                #if FF_LED_GAMMA == FF_LED_GAMMA_NONE && !defined(FF_LED_BRIGHTNESS)
+                    static inline ledLevelType outputLevel(ledLevelType _level) {return _level;} //!< No brightness curve
+                #else
+                    static ledLevelType outputLevel(ledLevelType _level);
+                #endif
+                #ifdef FF_LED_BRIGHTNESS
+                    static ledLevelType ledBrightness;          //!< Global brightness
+                    static uint8_t ledBrightnessSerial;         //!< Incremented on each global brightness change
+                #endif
+
+                // State of blink, pulse and timed pulse shares memory with sequence state (fields are set by each setter)
+                ledTimeType ledDelay;                           //!< Delay before next change
+                ledTimeType ledLastTimeChanged;                 //!< Last time led state changed
+                union {
+                    struct {
+                        ledTimeType ledOnDelay;                 //!< Delay to turn led on (or increasing brightness)
+                        ledTimeType ledOffDelay;                //!< Delay to turn led off (or decreasing brightness)
+                        ledTimeType ledWaitDelay;               //!< Delay to wait before next cycle
+                        union {
+                            struct {
+                                uint8_t ledBlinksNeeded;        //!< Count of LED blinks needed (blink mode)
+                                uint8_t ledBlinksDone;          //!< Count of LED blinks already done (blink mode)
+                            };
+                            ledTimeType ledCycleStart;          //!< Start time of current timed pulse cycle (timedPulse mode)
+                        };
+                    };
+                    struct {
+                        const ledStepType *ledSteps;            //!< Sequence steps table (sequence mode)
+                        ledTimeType ledStepStart;               //!< Start time of current step (sequence mode)
+                        uint8_t ledStepCount;                   //!< Count of steps in sequence (sequence mode)
+                        uint8_t ledStepIndex;                   //!< Current step (sequence mode)
+                    };
+                };
+                ledLevelType ledMinLevel;                       //!< Minimum level for pulse (start level of step in sequence mode)
+                ledLevelType ledMaxLevel;                       //!< Maximum level for pulse
+                ledLevelType ledLevel;                          //!< Current LED level
+                #ifdef FF_LED_COMPACT
+                    uint8_t ledMode : 3;                        //!< LED mode (ledModedType)
+                    bool ledIncrease : 1;                       //!< Requested pulse increase (repeat sequence in sequence mode)
+                    int8_t ledPulseIncrement : 2;               //!< Current (signed) pulse increment
+                #else
+                    uint8_t ledMode;                            //!< LED mode (ledModedType)
+                    bool ledIncrease;                           //!< Requested pulse increase (repeat sequence in sequence mode)
+                    int8_t ledPulseIncrement;                   //!< Current (signed) pulse increment
+                #endif
+        };
+
+        #ifdef FF_LED_COMPACT
+            static_assert(sizeof(FF_LEDCore) <= FF_LED_COMPACT_STATE_SIZE, "Compact FF_LEDCore is bigger than FF_LED_COMPACT_STATE_SIZE");
+        #endif
+
+        class FF_LED : public FF_LEDCore {
             /*!	\class FF_LED
                 \brief Implement few LED effects (fixed, blinking, pulsing) with brightness management
             */
             public:
-                FF_LED(uint8_t _ledPin, bool _isinverted = false, uint8_t _initialLevel = 0);
+                #ifdef FF_LED_STATS
+                    struct ledStatsType {
+                        unsigned long writes;                   //!< Count of values written to pin (or driver)
+                        unsigned long transitions;              //!< Count of state changes run by loop()
+                        unsigned long cycles;                   //!< Count of completed cycles (blink bursts, pulses, sequences)
+                        unsigned long maxLateness;              //!< Maximum time between deadline and state change (in ms)
+                        unsigned long averageLateness;          //!< Average time between deadline and state change (in ms)
+                    };
+                #endif
+                struct ledStateType {
+                    ledTimeType onDelay;                        //!< Delay to turn led on (or increasing brightness)
+                    ledTimeType offDelay;                       //!< Delay to turn led off (or decreasing brightness)
+                    ledTimeType waitDelay;                      //!< Delay to wait before next cycle
+                    ledTimeType delay;                          //!< Delay of current state
+                    ledTimeType elapsed;                        //!< Time spent in current state when saved
+                    ledTimeType phase;                          //!< Time between cycle (or step) start and current state start
+                    ledLevelType level;                         //!< Current LED level
+                    ledLevelType minLevel;                      //!< Minimum level (step start level in sequence mode)
+                    ledLevelType maxLevel;                      //!< Maximum level
+                    ledLevelType finalLevel;                    //!< Level kept after last cycle
+                    uint8_t flags;                              //!< Mode (bits 0-2), increase (bit 3), pulse increment + 1 (bits 4-5)
+                    uint8_t count;                              //!< Blinks needed (blink mode) or step count (sequence mode)
+                    uint8_t counter;                            //!< Blinks done (blink mode) or current step (sequence mode)
+                    uint8_t cyclesLeft;                         //!< Cycles to run before settling to final level (0 for ever)
+                };
+                typedef void (*ledCallbackType)(FF_LED *_led, uint8_t _events); //!< Effect events callback (_events is a ledEventType bit mask)
+                FF_LED(uint8_t _ledPin, bool _isinverted = false, ledLevelType _initialLevel = 0);
+                FF_LED(FF_LEDOutput *_output, uint8_t _channel, bool _isinverted = false, ledLevelType _initialLevel = 0);
                 ~FF_LED();
-                enum ledModedType {fixed, blink, pulse};        //!< LED mode definition
                 void begin(void);
-                void loop(void);
-                void setFixed(uint8_t _level);
-                void setBlink(uint8_t _blinkCount, unsigned long _onTime, unsigned long _offTime, unsigned long _waitTime, uint8_t _minLevel = 0, uint8_t _maxLevel = 255);
-                void setPulse(bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, uint8_t _minLevel = 0, uint8_t _maxLevel = 255);
+                unsigned long loop(void);
+                unsigned long nextChangeIn(void);
+                void setFixed(ledLevelType _level);
+                void setBlink(uint8_t _blinkCount, unsigned long _onTime, unsigned long _offTime, unsigned long _waitTime, ledLevelType _minLevel = 0, ledLevelType _maxLevel = FF_LED_MAX_LEVEL, uint8_t _cycleCount = 0, ledLevelType _finalLevel = 0);
+                void setPulse(bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel = 0, ledLevelType _maxLevel = FF_LED_MAX_LEVEL, uint8_t _cycleCount = 0, ledLevelType _finalLevel = 0);
+                void setTimedPulse(bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel = 0, ledLevelType _maxLevel = FF_LED_MAX_LEVEL, uint8_t _cycleCount = 0, ledLevelType _finalLevel = 0);
+                void setSequence(const ledStepType *_steps, uint8_t _stepCount, bool _repeat = true);
+                #ifdef FF_LED_TRANSITIONS
+                    void setTransition(unsigned long _transitionTime);
+                #endif
+                #ifdef FF_LED_CALLBACKS
+                    void setCallback(ledCallbackType _callback, uint8_t _events = ledCycleEnded | ledPeakReached | ledWaitStarted);
+                #endif
+                unsigned long getWritesAvoided(void);
+                void saveState(ledStateType *_state);
+                bool restoreState(const ledStateType *_state, const ledStepType *_steps = nullptr);
+                #ifdef FF_LED_TRANSITIONS
+                    /*! \brief Has LED no deadline (no running transition, and LED won't change until a new effect is set)? */
+                    inline bool isIdle(void) {return !ledTransiting && FF_LEDCore::isIdle();}
+                #endif
+                #ifdef FF_LED_STATS
+                    ledStatsType getStats(void);
+                    void resetStats(void);
+                #endif
             private:
-                void setLed(uint8_t _level, unsigned long _delay);
-
-                uint8_t ledPin = 0;                             //!< Pin where LEd is connected to
-                bool ledInverted = false;                       //!< Is LED inverted (turned on when pin level is low)?
-                uint8_t ledBlinksNeeded = 0;                    //!< Count of LED blinks needed
-                uint8_t ledBlinksDone = 0;                      //!< Count of LED blinks already done
-                uint8_t ledMinLevel = 0;                        //!< Minimum level for pulse
-                uint8_t ledMaxLevel = 255;                      //!< Maximum level for pulse
-                uint8_t ledLevel = 0;                           //!< Current LED level
-                bool ledIncrease = false;                       //!< Requested pulse increase
-                int8_t ledPulseIncrement = 0;                   //!< Current (signed) pulse increment
-                ledModedType ledMode = fixed;                   //!< LED mode
-                unsigned long ledOnDelay = 0;                   //!< Delay to turn led on (or increasing brightness)
-                unsigned long ledOffDelay = 0;                  //!< Delay to turn led off (or decreasing brightness)
-                unsigned long ledWaitDelay = 0;                 //!< Delay to wait before next cycle
-                unsigned long ledDelay = 0;                     //!< Delay before next change
-                unsigned long ledLastTimeChanged = 0;           //!< Last time led state changed
+                friend class FF_LEDGroup;
+                friend class FF_LEDSync;
+                friend class FF_LEDStack;
+                unsigned long nextChangeIn(unsigned long _now);
+                void loop(unsigned long _now);
+                void loopFrame(unsigned long _now);
+                void writeLed(void);
+                /*! \brief Write output again if global brightness changed since last write */
+                inline void refreshOutput(void) {
+                    #ifdef FF_LED_BRIGHTNESS
+                        if (ledWrittenSerial != ledBrightnessSerial) {
+                            writeLed();
+                        }
+                    #endif
+                }
+                /*! \brief Call callback if one of its events occured (nothing to do without FF_LED_CALLBACKS) */
+                inline void signalEvents(uint8_t _events) {
+                    #ifdef FF_LED_CALLBACKS
+                        if (ledCallback && (_events & ledCallbackEvents)) {
+                            ledCallback(this, _events & ledCallbackEvents);
+                        }
+                    #else
+                        (void) _events;
+                    #endif
+                }
+                void groupChanged(void);
+                void effectChanged(ledLevelType _previousLevel);
+                bool cycleEnded(ledTimeType _now);
+                #ifdef FF_LED_TRANSITIONS
+                    void startTransition(ledLevelType _previousLevel, ledTimeType _now);
+                    bool loopTransition(ledTimeType _now);
+                    void endTransition(void);
+                #endif
+                #ifdef FF_LED_HARDWARE_FADE
+                    uint8_t loopHardwarePulse(ledTimeType _now);
+                    void startFade(ledLevelType _level, ledTimeType _stepDelay, ledTimeType _now);
+                    void fadeTo(ledLevelType _level, ledTimeType _fadeTime, ledTimeType _now);
+                    void stopFade(void);
+                    static void ARDUINO_ISR_ATTR fadeDone(void *_led);
+                #endif
+
+                uint8_t ledPin = 0;                             //!< Pin where LEd is connected to (or driver channel)
+                #ifdef FF_LED_COMPACT
+                    bool ledInverted : 1;                       //!< Is LED inverted (turned on when pin level is low)?
+                    bool ledOutputValid : 1;                    //!< Is ledOutput the actual pin value?
+                    bool ledWritesHeld : 1;                     //!< Are writes held until end of frame?
+                    bool ledWritePending : 1;                   //!< Was a write held?
+                    ledLevelType ledOutput;                     //!< Last value written to pin (before inversion)
+                #else
+                    bool ledInverted = false;                   //!< Is LED inverted (turned on when pin level is low)?
+                    ledLevelType ledOutput = 0;                 //!< Last value written to pin (before inversion)
+                    bool ledOutputValid = false;                //!< Is ledOutput the actual pin value?
+                    bool ledWritesHeld = false;                 //!< Are writes held until end of frame?
+                    bool ledWritePending = false;               //!< Was a write held?
+                #endif
+                uint8_t ledCyclesLeft = 0;                      //!< Cycles to run before settling to final level (0 for ever)
+                ledLevelType ledFinalLevel = 0;                 //!< Level kept once last cycle ended
+                unsigned long ledWritesAvoided = 0;             //!< Count of pin writes skipped because value didn't change
+                #ifdef FF_LED_BRIGHTNESS
+                    uint8_t ledWrittenSerial = 0;               //!< Global brightness serial at last write
+                #endif
+                #ifdef FF_LED_POWER_BUDGET
+                    uint16_t ledPowerWeight = 1;                //!< Drive of LED at full level (in group budget unit)
+                    uint32_t ledPowerDrive = 0;                 //!< Drive of LED at requested output, counted in group (weight x 8 bits output)
+                #endif
+                #ifdef FF_LED_STATS
+                    ledStatsType ledStats = {0, 0, 0, 0, 0};    //!< Instrumentation counters (averageLateness computed by getStats())
+                    unsigned long ledLatenessTotal = 0;         //!< Sum of lateness of all state changes (in ms)
+                #endif
+                FF_LEDGroup *ledGroup = nullptr;                //!< Group this LED belongs to (if any)
+                FF_LEDOutput *ledDriver = nullptr;              //!< Output driver this LED is connected to (nullptr for native pin)
+                #ifdef FF_LED_CALLBACKS
+                    ledCallbackType ledCallback = nullptr;      //!< Effect events callback (nullptr for none)
+                    uint8_t ledCallbackEvents = 0;              //!< Events (ledEventType bit mask) given to callback
+                #endif
+                #ifdef FF_LED_TRANSITIONS
+                    ledTimeType ledTransitionTime = 0;          //!< Transition time applied to effect changes (0 for none)
+                    ledTimeType ledTransitionStart = 0;         //!< Start time of running transition
+                    ledTimeType ledTransitionDelay = 0;         //!< Delay of new effect first level (applied at transition end)
+                    ledLevelType ledTransitionFrom = 0;         //!< Level at transition start
+                    ledLevelType ledTransitionTo = 0;           //!< New effect first level (reached at transition end)
+                    bool ledTransiting = false;                 //!< Is a transition running?
+                #endif
+                #ifdef FF_LED_HARDWARE_FADE
+                    bool ledFading = false;                     //!< Is a hardware fade running?
+                    volatile bool ledFadeDone = false;          //!< Set by fade end interrupt
+                #endif
         };
     #endif
 #endif
\ No newline at end of file
@@ -0,0 +1,98 @@
+/*!
+	\file
+	\brief	74HC595 shift register chain output driver for FF_LED
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Chain is connected to SPI MOSI (SER) and SCK (SRCLK), latch (RCLK) to any pin.
+	Channel 0 is output QA of first chip (the one connected to MOSI).
+	Outputs are digital: values at half scale or more turn output on.
+
+	Bit buffer is given by caller (one byte per chip), so driver doesn't allocate any memory:
+
+		uint8_t shiftBits[3];
+		FF_LED74HC595 shiftChain(10, shiftBits, 3);
+		FF_LED led0(&shiftChain, 0);
+*/
+
+#include "FF_LED74HC595.h"
+#include <SPI.h>
+
+/*!
+
+	\brief	Class constructor
+
+	Initialize the class
+
+	\param[in]	_latchPin: pin connected to latch (RCLK)
+	\param[in]	_buffer: bit buffer to be used by driver (_chipCount bytes)
+	\param[in]	_chipCount: count of chips in chain
+	\param[in]	_spiClock: SPI clock (in Hz, default to 4 MHz)
+	\return	none
+
+*/
+FF_LED74HC595::FF_LED74HC595(uint8_t _latchPin, uint8_t *_buffer, uint8_t _chipCount, uint32_t _spiClock) {
+    shiftLatchPin = _latchPin;
+    shiftBuffer = _buffer;
+    shiftChipCount = _chipCount;
+    shiftSpiClock = _spiClock;
+    memset(shiftBuffer, 0, shiftChipCount);
+}
+
+/*!
+
+	\brief	Start driver
+
+	Start SPI and clear all outputs. Should be called in setup().
+
+	\return	none
+
+*/
+void FF_LED74HC595::begin(void) {
+    pinMode(shiftLatchPin, OUTPUT);
+    digitalWrite(shiftLatchPin, LOW);
+    SPI.begin();
+    outputDirty = true;                         // Force initial state
+    flush();
+}
+
+/*!
+
+	\brief	Stage a channel value
+
+	\param[in]	_channel: output number (0 to 8 * _chipCount - 1)
+	\param[in]	_value: value to write (0-FF_LED_MAX_LEVEL, already inverted if needed)
+	\return	none
+
+*/
+void FF_LED74HC595::write(uint8_t _channel, FF_LEDCore::ledLevelType _value) {
+    uint8_t chip = _channel >> 3;
+    if (chip >= shiftChipCount) {
+        return;
+    }
+    uint8_t mask = 1 << (_channel & 7);
+    uint8_t bits = (_value >= (FF_LED_MAX_LEVEL + 1) / 2) ? shiftBuffer[chip] | mask : shiftBuffer[chip] & ~mask;
+    if (bits != shiftBuffer[chip]) {
+        shiftBuffer[chip] = bits;
+        outputDirty = true;
+    }
+}
+
+/*!
+
+	\brief	Send staged values
+
+	Shift all chips in one SPI transfer, then latch outputs
+
+	\return	none
+
+*/
+void FF_LED74HC595::send(void) {
+    SPI.beginTransaction(SPISettings(shiftSpiClock, MSBFIRST, SPI_MODE0));
+    for (uint8_t i = shiftChipCount; i > 0; i--) {
+        SPI.transfer(shiftBuffer[i - 1]);       // Last chip of chain is shifted first
+    }
+    SPI.endTransaction();
+    digitalWrite(shiftLatchPin, HIGH);          // Latch all outputs at once
+    digitalWrite(shiftLatchPin, LOW);
+}
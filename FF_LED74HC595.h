@@ -0,0 +1,34 @@
+/*!
+	\file
+	\brief	74HC595 shift register chain output driver for FF_LED
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Have a look at FF_LED74HC595.cpp for details
+
+*/
+
+
+#ifndef FF_LED74HC595_h
+    #define FF_LED74HC595_h
+    #include "FF_LEDOutput.h"
+
+    #ifdef __cplusplus
+        class FF_LED74HC595 : public FF_LEDOutput {
+            /*!	\class FF_LED74HC595
+                \brief 74HC595 chain driven by SPI, all outputs shifted in one transfer
+            */
+            public:
+                FF_LED74HC595(uint8_t _latchPin, uint8_t *_buffer, uint8_t _chipCount, uint32_t _spiClock = 4000000);
+                void begin(void) override;
+                void write(uint8_t _channel, FF_LEDCore::ledLevelType _value) override;
+            protected:
+                void send(void) override;
+
+                uint8_t shiftLatchPin = 0;                      //!< Pin connected to latch (RCLK)
+                uint8_t *shiftBuffer = nullptr;                 //!< Output bits (given by caller, one byte per chip)
+                uint8_t shiftChipCount = 0;                     //!< Count of chips in chain
+                uint32_t shiftSpiClock = 0;                     //!< SPI clock (in Hz)
+        };
+    #endif
+#endif
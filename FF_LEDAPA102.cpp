@@ -0,0 +1,79 @@
+/*!
+	\file
+	\brief	APA102 (DotStar) LED strip output driver for FF_LED
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Strip is connected to SPI MOSI (DI) and SCK (CI). Frame buffer is sent in one SPI transaction,
+	from first pixel up to last changed one (each pixel forwards following data, so next pixels
+	keep their color). Pixels global brightness is set to maximum, levels being in colors.
+
+		FF_LEDStrip::pixelType stripPixels[30];
+		uint8_t stripFrame[30 * 3];
+		FF_LEDAPA102 strip(stripPixels, stripFrame, 30);
+		FF_LED pixel0(&strip, 0);
+*/
+
+#include "FF_LEDAPA102.h"
+#include <SPI.h>
+
+#define APA102_PIXEL_HEADER 0xFF                // Pixel frame start bits with global brightness set to 31
+
+/*!
+
+	\brief	Class constructor
+
+	Initialize the class
+
+	\param[in]	_pixels: pixels table to be used by driver (_pixelCount items)
+	\param[in]	_frame: frame buffer to be used by driver (3 * _pixelCount bytes)
+	\param[in]	_pixelCount: count of pixels in strip
+	\param[in]	_spiClock: SPI clock (in Hz, default to 4 MHz)
+	\return	none
+
+*/
+FF_LEDAPA102::FF_LEDAPA102(pixelType *_pixels, uint8_t *_frame, uint8_t _pixelCount, uint32_t _spiClock) : FF_LEDStrip(_pixels, _frame, _pixelCount, nullptr, bgr) {
+    apaSpiClock = _spiClock;
+}
+
+/*!
+
+	\brief	Start driver
+
+	Start SPI and push whole frame. Should be called in setup().
+
+	\return	none
+
+*/
+void FF_LEDAPA102::begin(void) {
+    SPI.begin();
+    FF_LEDStrip::begin();
+}
+
+/*!
+
+	\brief	Send staged values
+
+	Send start frame, pixels up to last changed one, then end frame
+
+	\return	none
+
+*/
+void FF_LEDAPA102::send(void) {
+    SPI.beginTransaction(SPISettings(apaSpiClock, MSBFIRST, SPI_MODE0));
+    for (uint8_t i = 0; i < 4; i++) {
+        SPI.transfer(0);                        // Start frame
+    }
+    const uint8_t *frame = stripFrame;
+    for (uint8_t i = 0; i < stripDirtyCount; i++) {
+        SPI.transfer(APA102_PIXEL_HEADER);
+        SPI.transfer(*frame++);
+        SPI.transfer(*frame++);
+        SPI.transfer(*frame++);
+    }
+    for (uint8_t i = 0; i < (stripDirtyCount + 15) / 16; i++) {
+        SPI.transfer(0);                        // End frame, one clock per 2 pixels to propagate data
+    }
+    SPI.endTransaction();
+    stripDirtyCount = 0;
+}
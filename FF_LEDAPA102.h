@@ -0,0 +1,30 @@
+/*!
+	\file
+	\brief	APA102 (DotStar) LED strip output driver for FF_LED
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Have a look at FF_LEDAPA102.cpp for details
+
+*/
+
+
+#ifndef FF_LEDAPA102_h
+    #define FF_LEDAPA102_h
+    #include "FF_LEDStrip.h"
+
+    #ifdef __cplusplus
+        class FF_LEDAPA102 : public FF_LEDStrip {
+            /*!	\class FF_LEDAPA102
+                \brief APA102 strip driven by SPI, frame pushed up to last changed pixel
+            */
+            public:
+                FF_LEDAPA102(pixelType *_pixels, uint8_t *_frame, uint8_t _pixelCount, uint32_t _spiClock = 4000000);
+                void begin(void) override;
+            protected:
+                void send(void) override;
+
+                uint32_t apaSpiClock = 0;                       //!< SPI clock (in Hz)
+        };
+    #endif
+#endif
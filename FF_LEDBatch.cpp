@@ -0,0 +1,424 @@
+/*!
+	\file
+	\brief	Animate many LEDs from parallel state arrays (structure of arrays)
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Batch gives fixed, blink, pulse and timed pulse effects of FF_LED (same semantics) to many LEDs, without
+	one object per LED. State is kept in one array per member, so that loop first scans delays
+	of all LEDs in one tight loop on contiguous arrays, without calls nor branches, that compilers
+	can vectorize. Only due LEDs then run the state machine.
+
+	As FF_LEDGroup, batch reads clock once, and returns immediately until the earliest change is due.
+
+	LED levels are read by getLevel(), or written to an output driver (FF_LEDStrip, FF_LEDPCA9685...)
+	given to setOutput(), flushed once per loop. Driver channels being 8 bits, a batch written to a
+	driver has at most 256 LEDs (larger batches are only read by getLevel()). Arrays are given by
+	caller, so batch doesn't allocate any memory:
+
+		FF_LEDBatchBuffers<120> batchBuffers;
+		FF_LEDBatch batch(batchBuffers);
+		batch.setOutput(&strip);
+
+	Sequences, transitions, cycle counts and hardware fade are not available with this class.
+	extras/host/batchCheck.cpp checks that batch gives the same outputs as FF_LED objects.
+*/
+
+#include "FF_LEDBatch.h"
+#include "FF_LEDOutput.h"
+
+/*!
+
+	\brief	Clear all LEDs
+
+	Set all LEDs to fixed level 0
+
+	\return	none
+
+*/
+void FF_LEDBatch::clear(void) {
+    for (uint16_t i = 0; i < batchCount; i++) {
+        batchLastTimes[i] = 0;
+        batchDelays[i] = FF_LEDCore::ledForEver;
+        batchOnDelays[i] = 0;
+        batchOffDelays[i] = 0;
+        batchWaitDelays[i] = 0;
+        batchLevels[i] = 0;
+        batchMinLevels[i] = 0;
+        batchMaxLevels[i] = FF_LED_MAX_LEVEL;
+        batchModes[i] = FF_LEDCore::fixed;
+        batchIncrements[i] = 0;
+        batchIncreases[i] = false;
+        batchBlinksNeeded[i] = 0;
+        batchBlinksDone[i] = 0;
+        batchCycleStarts[i] = 0;
+        batchDue[i] = false;
+    }
+}
+
+/*!
+
+	\brief	Start class
+
+	Write all LED levels to output driver (if any). Should be called in setup(), after starting driver.
+
+	\return	none
+
+*/
+void FF_LEDBatch::begin(void) {
+    for (uint16_t i = 0; i < batchCount; i++) {
+        writeLed(i);
+    }
+    batchChanged = true;                        // Flush and scan on next loop
+}
+
+/*!
+
+	\brief	Return count of LEDs in batch
+
+	\return	count of LEDs in batch
+
+*/
+uint16_t FF_LEDBatch::count(void) {
+    return batchCount;
+}
+
+/*!
+
+	\brief	Return LED level
+
+	\param[in]	_led: LED index in batch
+	\return	current LED level (0-FF_LED_MAX_LEVEL, before brightness curve)
+
+*/
+FF_LEDBatch::ledLevelType FF_LEDBatch::getLevel(uint16_t _led) {
+    return (_led < batchCount) ? batchLevels[_led] : 0;
+}
+
+/*!
+
+	\brief	Set output driver
+
+	Write LED levels to an output driver, LED n being driver channel _firstChannel + n.
+	Last LED channel should not exceed 255 (driver channels are 8 bits).
+
+	\param[in]	_output: output driver (nullptr to stop writing)
+	\param[in]	_firstChannel: driver channel of first LED (default to 0)
+	\return	true if output set, false if some LEDs of batch would be after channel 255 (output not changed)
+
+*/
+bool FF_LEDBatch::setOutput(FF_LEDOutput *_output, uint8_t _firstChannel) {
+    if (_output && _firstChannel + batchCount > 256) {
+        return false;                           // Channels would wrap and alias
+    }
+    batchOutput = _output;
+    batchFirstChannel = _firstChannel;
+    return true;
+}
+
+/*!
+
+	\brief	Set LED to fixed level
+
+	\param[in]	_led: LED index in batch
+	\param[in]	_level: LED level to set (0-FF_LED_MAX_LEVEL)
+	\return	none
+
+*/
+void FF_LEDBatch::setFixed(uint16_t _led, ledLevelType _level) {
+    if (_led >= batchCount) {
+        return;
+    }
+    FF_LED_ENTER_CRITICAL();                    // Protect state against timer driven loop
+    batchModes[_led] = FF_LEDCore::fixed;
+    setLed(_led, _level, FF_LEDCore::ledForEver, FF_LEDCore::toTicks(millis()));
+    writeLed(_led);
+    batchChanged = true;
+    FF_LED_EXIT_CRITICAL();
+}
+
+/*!
+
+	\brief	Set LED blink count
+
+	Start LED blinking sequence (see FF_LED::setBlink())
+
+	\param[in]	_led: LED index in batch
+	\param[in]	_blinkCount: number of  time to blink LED
+	\param[in]	_onTime: time to light the LED (in ms)
+	\param[in]	_offTime: time to keep LED off (in ms)
+	\param[in]	_waitTime: time to wait after the blink sequence of _blinkCount
+	\param[in]	_minLevel: minimum (OFF) LED level (0-FF_LED_MAX_LEVEL, default to 0)
+	\param[in]	_maxLevel: maximum (ON) LED level (0-FF_LED_MAX_LEVEL, default to FF_LED_MAX_LEVEL)
+	\return	none
+
+*/
+void FF_LEDBatch::setBlink(uint16_t _led, uint8_t _blinkCount, unsigned long _onTime, unsigned long _offTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel) {
+    if (_led >= batchCount) {
+        return;
+    }
+    FF_LED_ENTER_CRITICAL();
+    batchBlinksNeeded[_led] = _blinkCount;
+    batchOnDelays[_led] = FF_LEDCore::toDelay(_onTime);
+    batchOffDelays[_led] = FF_LEDCore::toDelay(_offTime);
+    batchWaitDelays[_led] = FF_LEDCore::toDelay(_waitTime);
+    batchMinLevels[_led] = _minLevel;
+    batchMaxLevels[_led] = _maxLevel;
+    batchBlinksDone[_led] = 0;
+    batchModes[_led] = FF_LEDCore::blink;
+    if (_blinkCount) {                          // Any blink?
+        setLed(_led, _maxLevel, batchOnDelays[_led], FF_LEDCore::toTicks(millis()));
+    } else {
+        setLed(_led, _minLevel, batchWaitDelays[_led], FF_LEDCore::toTicks(millis()));
+    }
+    writeLed(_led);
+    batchChanged = true;
+    FF_LED_EXIT_CRITICAL();
+}
+
+/*!
+
+	\brief	Set LED continous pulse
+
+	Start LED pulse sequence (see FF_LED::setPulse())
+
+	\param[in]	_led: LED index in batch
+	\param[in]	_increase: set to true to start from _minLevel, false to start from _maxLevel
+	\param[in]	_upTime: time to wait between 2 increases (in ms)
+	\param[in]	_downTime: time to wait between 2 decreases (in ms)
+	\param[in]	_waitTime: time to wait after one pulse sequence
+	\param[in]	_minLevel: minimum LED level (0-FF_LED_MAX_LEVEL, default to 0)
+	\param[in]	_maxLevel: maximum LED level (0-FF_LED_MAX_LEVEL, default to FF_LED_MAX_LEVEL)
+	\return	none
+
+*/
+void FF_LEDBatch::setPulse(uint16_t _led, bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel) {
+    if (_led >= batchCount) {
+        return;
+    }
+    FF_LED_ENTER_CRITICAL();
+    batchIncreases[_led] = _increase;
+    batchMinLevels[_led] = _minLevel;
+    batchMaxLevels[_led] = _maxLevel;
+    batchOnDelays[_led] = FF_LEDCore::toDelay(_upTime);
+    batchOffDelays[_led] = FF_LEDCore::toDelay(_downTime);
+    batchWaitDelays[_led] = FF_LEDCore::toDelay(_waitTime);
+    batchModes[_led] = FF_LEDCore::pulse;
+    if (_increase) {
+        batchIncrements[_led] = 1;
+        setLed(_led, _minLevel, batchOnDelays[_led], FF_LEDCore::toTicks(millis()));
+    } else {
+        batchIncrements[_led] = -1;
+        setLed(_led, _maxLevel, batchOffDelays[_led], FF_LEDCore::toTicks(millis()));
+    }
+    writeLed(_led);
+    batchChanged = true;
+    FF_LED_EXIT_CRITICAL();
+}
+
+/*!
+
+	\brief	Set LED continous time based pulse
+
+	Start LED time based pulse sequence (see FF_LED::setTimedPulse())
+
+	\param[in]	_led: LED index in batch
+	\param[in]	_increase: set to true to start from _minLevel, false to start from _maxLevel
+	\param[in]	_upTime: total time to go from _minLevel to _maxLevel (in ms)
+	\param[in]	_downTime: total time to go from _maxLevel to _minLevel (in ms)
+	\param[in]	_waitTime: time to wait after one pulse sequence
+	\param[in]	_minLevel: minimum LED level (0-FF_LED_MAX_LEVEL, default to 0)
+	\param[in]	_maxLevel: maximum LED level (0-FF_LED_MAX_LEVEL, default to FF_LED_MAX_LEVEL)
+	\return	none
+
+*/
+void FF_LEDBatch::setTimedPulse(uint16_t _led, bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel) {
+    if (_led >= batchCount) {
+        return;
+    }
+    FF_LED_ENTER_CRITICAL();
+    batchIncreases[_led] = _increase;
+    batchMinLevels[_led] = _minLevel;
+    batchMaxLevels[_led] = _maxLevel;
+    batchOnDelays[_led] = FF_LEDCore::toDelay(_upTime);
+    batchOffDelays[_led] = FF_LEDCore::toDelay(_downTime);
+    batchWaitDelays[_led] = FF_LEDCore::toDelay(_waitTime);
+    batchModes[_led] = FF_LEDCore::timedPulse;
+    batchCycleStarts[_led] = FF_LEDCore::toTicks(millis()); // Cycle starts now
+    stepTimedPulse(_led, batchCycleStarts[_led]);           // Set initial level
+    writeLed(_led);
+    batchChanged = true;
+    FF_LED_EXIT_CRITICAL();
+}
+
+/*!
+
+	\brief	Set LED level
+
+	\param[in]	_led: LED index in batch
+	\param[in]	_level: LED level (0-FF_LED_MAX_LEVEL) to set
+	\param[in]	_delay: time to stay at this level (in ticks)
+	\param[in]	_now: current time (in ticks)
+	\return	none
+
+*/
+void FF_LED_IRAM_ATTR FF_LEDBatch::setLed(uint16_t _led, ledLevelType _level, ledTimeType _delay, ledTimeType _now) {
+    batchLevels[_led] = _level;
+    batchDelays[_led] = _delay;
+    batchLastTimes[_led] = _now;
+}
+
+/*!
+
+	\brief	Write LED level to output driver
+
+	\param[in]	_led: LED index in batch
+	\return	none
+
+*/
+void FF_LED_IRAM_ATTR FF_LEDBatch::writeLed(uint16_t _led) {
+    if (batchOutput) {
+        batchOutput->write((uint8_t) (batchFirstChannel + _led), FF_LEDCore::outputLevel(batchLevels[_led])); // Apply brightness curve
+    }
+}
+
+/*!
+
+	\brief	Loop
+
+	Loop part of class. Should be called in loop().
+
+	Returned value may be used to sleep (using delay(), light sleep, vTaskDelay()...) until next change.
+
+	\return	time before next change of any LED in batch (in ms), FF_LED_WAIT_FOR_EVER if no LED will ever change
+
+*/
+unsigned long FF_LED_IRAM_ATTR FF_LEDBatch::loop(void) {
+    if (!batchChanged && batchWaitTime == FF_LED_WAIT_FOR_EVER) {
+        return FF_LED_WAIT_FOR_EVER;            // All LEDs idle, don't even read clock
+    }
+    unsigned long now = millis();               // Read clock only once
+    unsigned long elapsed = (uint32_t) (now - batchLastTime); // Wraps with millis(), even where unsigned long is 64 bits
+    if (!batchChanged && elapsed < batchWaitTime) {
+        if (batchWaitTime == FF_LED_WAIT_FOR_EVER) {
+            return FF_LED_WAIT_FOR_EVER;
+        }
+        return batchWaitTime - elapsed;         // Nothing due yet
+    }
+    FF_LED_ENTER_CRITICAL();
+    ledTimeType nowTicks = FF_LEDCore::toTicks(now);
+    ledTimeType waitTicks = FF_LEDCore::ledForEver;
+    uint16_t dueCount = 0;
+    uint16_t ledCount = batchCount;             // Local copies, as due flags writes may alias members
+    const ledTimeType *lastTimes = batchLastTimes;
+    const ledTimeType *delays = batchDelays;
+    uint8_t *dues = batchDue;
+    // First pass: compare all delays, keep earliest one (no calls nor branches, so that it can be vectorized)
+    for (uint16_t i = 0; i < ledCount; i++) {
+        ledTimeType ledElapsed = nowTicks - lastTimes[i];
+        ledTimeType ledDelay = delays[i];
+        ledTimeType due = ledElapsed > ledDelay;
+        // Remaining time, forced to ledForEver (all bits set) if LED is due or never changes
+        ledTimeType remaining = (ledDelay - ledElapsed) | ((ledTimeType) 0 - (due | (ledDelay == FF_LEDCore::ledForEver)));
+        dues[i] = due;
+        dueCount += due;
+        waitTicks = (remaining < waitTicks) ? remaining : waitTicks;
+    }
+    // Second pass: run state machine of due LEDs only
+    for (uint16_t i = 0; dueCount && i < batchCount; i++) {
+        if (batchDue[i]) {
+            dueCount--;
+            step(i, nowTicks);
+            writeLed(i);
+            if (batchDelays[i] != FF_LEDCore::ledForEver && batchDelays[i] < waitTicks) {
+                waitTicks = batchDelays[i];     // Keep earliest change
+            }
+        }
+    }
+    FF_LED_EXIT_CRITICAL();
+    if (batchOutput) {
+        batchOutput->flush();                   // One transaction for all changed LEDs
+    }
+    unsigned long waitTime = FF_LED_WAIT_FOR_EVER;
+    if (waitTicks != FF_LEDCore::ledForEver) {
+        // Change occurs when elapsed ticks exceed delay, remove part of current tick already elapsed
+        waitTime = ((unsigned long) waitTicks + 1) * FF_LED_TICK_MS - (now % FF_LED_TICK_MS);
+    }
+    batchLastTime = now;
+    batchWaitTime = waitTime;
+    batchChanged = false;
+    return waitTime;
+}
+
+/*!
+
+	\brief	Run state machine of one LED
+
+	Same state machine as FF_LEDCore::loop(), on batch arrays
+
+	\param[in]	_led: LED index in batch
+	\param[in]	_now: current time (in ticks)
+	\return	none
+
+*/
+void FF_LED_IRAM_ATTR FF_LEDBatch::step(uint16_t _led, ledTimeType _now) {
+    ledLevelType minLevel = batchMinLevels[_led];
+    ledLevelType maxLevel = batchMaxLevels[_led];
+    if (batchModes[_led] == FF_LEDCore::blink) {
+        if (batchLevels[_led] == maxLevel) {    // LED is on
+            batchBlinksDone[_led]++;
+            setLed(_led, minLevel, batchOffDelays[_led], _now);
+        } else if (batchBlinksDone[_led] >= batchBlinksNeeded[_led]) { // All blinks done
+            batchBlinksDone[_led] = 0;
+            setLed(_led, minLevel, batchWaitDelays[_led], _now);
+        } else {
+            setLed(_led, maxLevel, batchOnDelays[_led], _now);
+        }
+    } else if (batchModes[_led] == FF_LEDCore::pulse) {
+        int32_t newLevel = (int32_t) batchLevels[_led] + batchIncrements[_led];
+        if (batchIncrements[_led] > 0) {        // Are we increasing level?
+            if (newLevel > maxLevel) {
+                setLed(_led, maxLevel, batchIncreases[_led] ? batchOffDelays[_led] : batchWaitDelays[_led], _now);
+                batchIncrements[_led] = -1;     // Revert way
+            } else {
+                setLed(_led, (ledLevelType) newLevel, batchOnDelays[_led], _now);
+            }
+        } else {                                // We are decreasing level
+            if (newLevel < minLevel) {
+                setLed(_led, minLevel, batchIncreases[_led] ? batchWaitDelays[_led] : batchOnDelays[_led], _now);
+                batchIncrements[_led] = 1;      // Revert way
+            } else {
+                setLed(_led, (ledLevelType) newLevel, batchOffDelays[_led], _now);
+            }
+        }
+    } else if (batchModes[_led] == FF_LEDCore::timedPulse) {
+        stepTimedPulse(_led, _now);
+    }
+}
+
+/*!
+
+	\brief	Run time based pulse of one LED
+
+	Level computation being much longer than a blink or pulse step, FF_LEDCore::loopTimedPulse()
+	is run on a copy of LED state, instead of being duplicated here
+
+	\param[in]	_led: LED index in batch
+	\param[in]	_now: current time (in ticks)
+	\return	none
+
+*/
+void FF_LED_IRAM_ATTR FF_LEDBatch::stepTimedPulse(uint16_t _led, ledTimeType _now) {
+    FF_LEDCore core(batchLevels[_led]);
+    core.ledIncrease = batchIncreases[_led];
+    core.ledMinLevel = batchMinLevels[_led];
+    core.ledMaxLevel = batchMaxLevels[_led];
+    core.ledOnDelay = batchOnDelays[_led];
+    core.ledOffDelay = batchOffDelays[_led];
+    core.ledWaitDelay = batchWaitDelays[_led];
+    core.ledLastTimeChanged = batchLastTimes[_led];
+    core.ledCycleStart = batchCycleStarts[_led];
+    core.loopTimedPulse(_now);
+    batchCycleStarts[_led] = core.ledCycleStart;
+    setLed(_led, core.ledLevel, core.ledDelay, _now);
+}
@@ -0,0 +1,101 @@
+/*!
+	\file
+	\brief	Animate many LEDs from parallel state arrays (structure of arrays)
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Have a look at FF_LEDBatch.cpp for details
+
+*/
+
+
+#ifndef FF_LEDBatch_h
+    #define FF_LEDBatch_h
+    #include "FF_LED.h"
+
+    #ifdef __cplusplus
+        class FF_LEDOutput;
+
+        template <uint16_t ledCount>
+        struct FF_LEDBatchBuffers {
+            /*!	\struct FF_LEDBatchBuffers
+                \brief Storage of a FF_LEDBatch of ledCount LEDs, one array per state member
+            */
+            FF_LEDCore::ledTimeType lastTime[ledCount];         //!< Last time LED state changed
+            FF_LEDCore::ledTimeType delay[ledCount];            //!< Delay before next change
+            FF_LEDCore::ledTimeType onDelay[ledCount];          //!< Delay to turn LED on (or increasing brightness)
+            FF_LEDCore::ledTimeType offDelay[ledCount];         //!< Delay to turn LED off (or decreasing brightness)
+            FF_LEDCore::ledTimeType waitDelay[ledCount];        //!< Delay to wait before next cycle
+            FF_LEDCore::ledLevelType level[ledCount];           //!< Current LED level
+            FF_LEDCore::ledLevelType minLevel[ledCount];        //!< Minimum level
+            FF_LEDCore::ledLevelType maxLevel[ledCount];        //!< Maximum level
+            uint8_t mode[ledCount];                             //!< LED mode (FF_LEDCore::ledModedType)
+            int8_t increment[ledCount];                         //!< Current (signed) pulse increment
+            uint8_t increase[ledCount];                         //!< Requested pulse increase
+            uint8_t blinksNeeded[ledCount];                     //!< Count of LED blinks needed
+            uint8_t blinksDone[ledCount];                       //!< Count of LED blinks already done
+            FF_LEDCore::ledTimeType cycleStart[ledCount];       //!< Start time of current timed pulse cycle
+            uint8_t due[ledCount];                              //!< LED change is due (set by first pass of loop)
+        };
+
+        class FF_LEDBatch {
+            /*!	\class FF_LEDBatch
+                \brief Fixed, blink, pulse and timed pulse effects for many LEDs, state kept in parallel arrays
+            */
+            public:
+                typedef FF_LEDCore::ledLevelType ledLevelType;  //!< LED level definition
+                typedef FF_LEDCore::ledTimeType ledTimeType;    //!< Time and delay definition
+
+                /*!
+                    \brief	Class constructor
+                    \param[in]	_buffers: state arrays to be used by batch
+                */
+                template <uint16_t ledCount>
+                FF_LEDBatch(FF_LEDBatchBuffers<ledCount> &_buffers) :
+                    batchLastTimes(_buffers.lastTime), batchDelays(_buffers.delay), batchOnDelays(_buffers.onDelay),
+                    batchOffDelays(_buffers.offDelay), batchWaitDelays(_buffers.waitDelay), batchLevels(_buffers.level),
+                    batchMinLevels(_buffers.minLevel), batchMaxLevels(_buffers.maxLevel), batchModes(_buffers.mode),
+                    batchIncrements(_buffers.increment), batchIncreases(_buffers.increase), batchBlinksNeeded(_buffers.blinksNeeded),
+                    batchBlinksDone(_buffers.blinksDone), batchCycleStarts(_buffers.cycleStart), batchDue(_buffers.due), batchCount(ledCount) {
+                    clear();
+                }
+                void begin(void);
+                unsigned long loop(void);
+                uint16_t count(void);
+                ledLevelType getLevel(uint16_t _led);
+                bool setOutput(FF_LEDOutput *_output, uint8_t _firstChannel = 0);
+                void setFixed(uint16_t _led, ledLevelType _level);
+                void setBlink(uint16_t _led, uint8_t _blinkCount, unsigned long _onTime, unsigned long _offTime, unsigned long _waitTime, ledLevelType _minLevel = 0, ledLevelType _maxLevel = FF_LED_MAX_LEVEL);
+                void setPulse(uint16_t _led, bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel = 0, ledLevelType _maxLevel = FF_LED_MAX_LEVEL);
+                void setTimedPulse(uint16_t _led, bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel = 0, ledLevelType _maxLevel = FF_LED_MAX_LEVEL);
+            private:
+                void clear(void);
+                void setLed(uint16_t _led, ledLevelType _level, ledTimeType _delay, ledTimeType _now);
+                void step(uint16_t _led, ledTimeType _now);
+                void stepTimedPulse(uint16_t _led, ledTimeType _now);
+                void writeLed(uint16_t _led);
+
+                ledTimeType *batchLastTimes;                    //!< Last time LED state changed
+                ledTimeType *batchDelays;                       //!< Delay before next change
+                ledTimeType *batchOnDelays;                     //!< Delay to turn LED on (or increasing brightness)
+                ledTimeType *batchOffDelays;                    //!< Delay to turn LED off (or decreasing brightness)
+                ledTimeType *batchWaitDelays;                   //!< Delay to wait before next cycle
+                ledLevelType *batchLevels;                      //!< Current LED level
+                ledLevelType *batchMinLevels;                   //!< Minimum level
+                ledLevelType *batchMaxLevels;                   //!< Maximum level
+                uint8_t *batchModes;                            //!< LED mode (FF_LEDCore::ledModedType)
+                int8_t *batchIncrements;                        //!< Current (signed) pulse increment
+                uint8_t *batchIncreases;                        //!< Requested pulse increase
+                uint8_t *batchBlinksNeeded;                     //!< Count of LED blinks needed
+                uint8_t *batchBlinksDone;                       //!< Count of LED blinks already done
+                ledTimeType *batchCycleStarts;                  //!< Start time of current timed pulse cycle
+                uint8_t *batchDue;                              //!< LED change is due
+                uint16_t batchCount;                            //!< Count of LEDs in batch
+                FF_LEDOutput *batchOutput = nullptr;            //!< Output driver written with LED levels (if any)
+                uint8_t batchFirstChannel = 0;                  //!< Driver channel of first LED
+                bool batchChanged = true;                       //!< One LED changed outside of batch loop
+                unsigned long batchLastTime = 0;                //!< Last time batch was scanned
+                unsigned long batchWaitTime = 0;                //!< Time to wait after last scan before next LED change
+        };
+    #endif
+#endif
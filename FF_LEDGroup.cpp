@@ -0,0 +1,484 @@
+/*!
+	\file
+	\brief	Manage a group of FF_LED with a single scheduler
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Instead of calling loop() of each LED, sketch adds all its LEDs to a group and calls group's loop().
+
+	Group reads clock once, and returns immediately until the earliest LED change is due.
+	Then it runs all LEDs with the same clock value and computes the next earliest change.
+
+	LED table is given by caller, so group doesn't allocate any memory:
+
+		FF_LED *myLeds[24];
+		FF_LEDGroup myGroup(myLeds, 24);
+
+	When FF_LED_TIMER_DRIVEN is defined, group may be run from a timer instead of sketch's loop(),
+	so that LED timing doesn't depend on main loop latency. On ESP8266/ESP32, call beginTimer()
+	to start a Ticker. On other targets, call timerLoop() from your own timer interrupt.
+	Setters of FF_LED protect their changes with a critical section in this mode.
+	Whole scan, as setters, runs inside one critical section (interrupts masked), including pin writes.
+	Only LEDs on pins switched fully on or off are supported in this mode: levels 0 and
+	FF_LED_MAX_LEVEL are written with digitalWrite(), which is safe with interrupts masked, but other
+	levels use analogWrite(), which may allocate and log on first use of a pin (LEDC channel attach
+	on ESP32 core 3). So use only fixed 0/FF_LED_MAX_LEVEL levels and blinks between them, without
+	pulses, timed pulses, sequences, transitions, brightness nor power budget. Output drivers
+	(FF_LED74HC595, FF_LEDPCA9685, strips...) and callbacks are not supported either: bus libraries
+	can't be called from an interrupt, and a callback would run with interrupts masked.
+
+	LEDs connected to output drivers are written to driver buffers during loop, and each driver
+	is flushed once at end of loop, giving one bus transaction per driver and per loop.
+
+	Update rate may be limited with setFrameRate(): LEDs are then scanned at most once per frame.
+	All changes due during a frame are run at frame end, each one at its own deadline (so that
+	effect timing stays exact), and each LED is written once with its last level. This bounds
+	CPU and bus cost whatever the count of LEDs and the speed of effects. Levels lasting less than a
+	frame may thus never be written. Setters still write at once.
+
+	When FF_LED_POWER_BUDGET is defined, group may limit total drive of its LEDs (to protect a
+	weak power supply). Each LED has a weight (its drive at full level, 1 by default), and group
+	keeps the sum of weight x output of all LEDs, updated by each write (never recomputed over
+	all LEDs). When sum exceeds budget, outputs of all LEDs are scaled down by the same ratio,
+	keeping their levels and effects untouched:
+
+		myGroup.setPowerWeight(&statusLed, 20);  // 20 mA at full level
+		myGroup.setPowerWeight(&floodLed, 350);
+		myGroup.setPowerBudget(300);            // At most 300 mA for all LEDs of group
+
+	Scale is computed again at end of each loop where total changed, and all LEDs are written
+	again only when scale changes. Changes done by setters are thus limited on next loop.
+*/
+
+#include "FF_LEDGroup.h"
+#include "FF_LEDOutput.h"
+
+/*!
+
+	\brief	Class constructor
+
+	Initialize the class
+
+	\param[in]	_leds: table of FF_LED pointers to be used by group
+	\param[in]	_maxLeds: size of _leds table
+	\return	none
+
+*/
+FF_LEDGroup::FF_LEDGroup(FF_LED **_leds, uint8_t _maxLeds) {
+    groupLeds = _leds;
+    groupMaxLeds = _maxLeds;
+    groupLedCount = 0;
+}
+
+/*!
+
+	\brief	Add a LED to group
+
+	Add a LED to group. LED's loop() doesn't have to be called anymore.
+
+	\param[in]	_led: LED to add
+	\return	true if LED added, false if table is full or LED already in a group
+
+*/
+bool FF_LEDGroup::add(FF_LED *_led) {
+    bool added = false;
+    FF_LED_ENTER_CRITICAL();                    // Protect table against timer driven loop
+    if (groupLedCount < groupMaxLeds && !_led->ledGroup) {
+        groupLeds[groupLedCount++] = _led;
+        _led->ledGroup = this;
+        #ifdef FF_LED_POWER_BUDGET
+            _led->ledPowerDrive = 0;
+            if (_led->ledOutputValid) {         // LED already started, count it and scale it now
+                _led->writeLed();
+            }
+        #endif
+        groupChanged = true;                    // Force a scan on next loop
+        added = true;
+    }
+    FF_LED_EXIT_CRITICAL();
+    return added;
+}
+
+/*!
+
+	\brief	Remove a LED from group
+
+	Remove a LED from group. LED's loop() should then be called again by sketch.
+
+	\param[in]	_led: LED to remove
+	\return	true if LED removed, false if LED is not in group
+
+*/
+bool FF_LEDGroup::remove(FF_LED *_led) {
+    bool removed = false;
+    FF_LED_ENTER_CRITICAL();                    // Protect table against timer driven loop
+    for (uint8_t i = 0; i < groupLedCount; i++) {
+        if (groupLeds[i] == _led) {
+            groupLedCount--;
+            for (uint8_t j = i; j < groupLedCount; j++) {
+                groupLeds[j] = groupLeds[j + 1];
+            }
+            _led->ledGroup = nullptr;
+            #ifdef FF_LED_POWER_BUDGET
+                groupPowerDemand -= _led->ledPowerDrive;
+                _led->ledPowerDrive = 0;
+                groupPowerChanged = true;
+                if (_led->ledOutputValid) {     // Write LED again without group scale
+                    _led->writeLed();
+                }
+            #endif
+            groupChanged = true;                // Force a scan on next loop
+            removed = true;
+            break;
+        }
+    }
+    FF_LED_EXIT_CRITICAL();
+    return removed;
+}
+
+/*!
+
+	\brief	Return count of LEDs in group
+
+	\return	count of LEDs in group
+
+*/
+uint8_t FF_LEDGroup::count(void) {
+    return groupLedCount;
+}
+
+/*!
+
+	\brief	Set maximum update rate
+
+	Limit scans of group to a given rate, writing each LED at most once per frame
+
+	\param[in]	_framesPerSecond: maximum count of scans per second (0 for no limit)
+	\return	none
+
+*/
+void FF_LEDGroup::setFrameRate(uint16_t _framesPerSecond) {
+    FF_LED_ENTER_CRITICAL();
+    groupFramePeriod = _framesPerSecond ? (1000 + _framesPerSecond - 1) / _framesPerSecond : 0; // Round up, not to exceed rate
+    groupChanged = true;
+    FF_LED_EXIT_CRITICAL();
+}
+
+/*!
+
+	\brief	Save effect state of all LEDs
+
+	Save state of each LED (see FF_LED::saveState()), in group order
+
+	\param[out]	_states: table of snapshots to fill (one per LED)
+	\param[in]	_maxStates: size of _states table
+	\return	count of snapshots filled
+
+*/
+uint8_t FF_LEDGroup::saveState(FF_LED::ledStateType *_states, uint8_t _maxStates) {
+    uint8_t count = 0;
+    for (; count < groupLedCount && count < _maxStates; count++) {
+        groupLeds[count]->saveState(&_states[count]);
+    }
+    return count;
+}
+
+/*!
+
+	\brief	Restore effect state of all LEDs
+
+	Restore state of each LED (see FF_LED::restoreState()), in group order. LEDs should have been added
+	in the same order as when states were saved. Sequences are restored only on LEDs already running
+	the same sequence (set in setup() before restoring).
+
+	\param[in]	_states: table of snapshots
+	\param[in]	_stateCount: count of snapshots in _states table
+	\return	count of LEDs restored
+
+*/
+uint8_t FF_LEDGroup::restoreState(const FF_LED::ledStateType *_states, uint8_t _stateCount) {
+    uint8_t restored = 0;
+    for (uint8_t i = 0; i < groupLedCount && i < _stateCount; i++) {
+        if (groupLeds[i]->restoreState(&_states[i])) {
+            restored++;
+        }
+    }
+    return restored;
+}
+
+/*!
+
+	\brief	Start class
+
+	Start all LEDs in group. Should be called in setup(), after adding LEDs.
+
+	\return	none
+
+*/
+void FF_LEDGroup::begin(void) {
+    for (uint8_t i = 0; i < groupLedCount; i++) {
+        groupLeds[i]->begin();
+    }
+}
+
+/*!
+
+	\brief	Signal that one LED changed
+
+	Called by LED when its level or delay changes, to force a new scan
+
+	\return	none
+
+*/
+void FF_LED_IRAM_ATTR FF_LEDGroup::ledChanged(void) {
+    groupChanged = true;
+}
+
+#ifdef FF_LED_POWER_BUDGET
+/*!
+
+	\brief	Set power budget
+
+	Limit sum of drives of all LEDs in group. Outputs are scaled down proportionally when exceeded.
+
+	\param[in]	_budget: maximum total drive (in LED weight unit, 0 for no limit)
+	\return	none
+
+*/
+void FF_LEDGroup::setPowerBudget(uint16_t _budget) {
+    FF_LED_ENTER_CRITICAL();
+    groupPowerLimit = (uint32_t) _budget * 255;
+    groupPowerChanged = true;                   // Compute scale on next loop
+    groupChanged = true;
+    FF_LED_EXIT_CRITICAL();
+}
+
+/*!
+
+	\brief	Set power weight of a LED
+
+	\param[in]	_led: LED to set weight of (in group or not yet added)
+	\param[in]	_weight: drive of LED at full level (in budget unit, 1 by default)
+	\return	none
+
+*/
+void FF_LEDGroup::setPowerWeight(FF_LED *_led, uint16_t _weight) {
+    FF_LED_ENTER_CRITICAL();
+    _led->ledPowerWeight = _weight;
+    if (_led->ledGroup == this && _led->ledOutputValid) {
+        _led->writeLed();                       // Count new drive
+        groupChanged = true;
+    }
+    FF_LED_EXIT_CRITICAL();
+}
+
+/*!
+
+	\brief	Return power demand
+
+	\return	sum of drives requested by LEDs of group, before scaling (in budget unit, rounded up)
+
+*/
+uint32_t FF_LEDGroup::getPowerDemand(void) {
+    return (groupPowerDemand + 254) / 255;
+}
+
+/*!
+
+	\brief	Count drive of a LED
+
+	Called by LED on each write, to update group total with difference between new and previous drive
+
+	\param[in]	_led: LED being written
+	\param[in]	_output: LED output (after brightness curve, before scaling)
+	\return	none
+
+*/
+void FF_LED_IRAM_ATTR FF_LEDGroup::powerDemand(FF_LED *_led, FF_LEDCore::ledLevelType _output) {
+    uint32_t drive = (uint32_t) _led->ledPowerWeight * (_output >> (FF_LED_LEVEL_BITS - 8));
+    if (drive != _led->ledPowerDrive) {
+        groupPowerDemand += drive - _led->ledPowerDrive;
+        _led->ledPowerDrive = drive;
+        groupPowerChanged = true;
+    }
+}
+
+/*!
+
+	\brief	Apply power scale to an output
+
+	\param[in]	_output: LED output (after brightness curve)
+	\return	output to write
+
+*/
+FF_LEDCore::ledLevelType FF_LED_IRAM_ATTR FF_LEDGroup::powerScale(FF_LEDCore::ledLevelType _output) {
+    if (groupPowerScale >= 256) {
+        return _output;
+    }
+    return ((uint32_t) _output * groupPowerScale) >> 8;
+}
+
+/*!
+
+	\brief	Compute power scale
+
+	Compute scale from total drive if it changed, writing all LEDs again if scale changed
+
+	\return	true if LEDs were written again
+
+*/
+bool FF_LED_IRAM_ATTR FF_LEDGroup::updatePowerScale(void) {
+    if (!groupPowerChanged) {
+        return false;
+    }
+    groupPowerChanged = false;
+    uint16_t scale = 256;
+    if (groupPowerLimit && groupPowerDemand > groupPowerLimit) {
+        uint32_t limit = groupPowerLimit;
+        uint32_t demand = groupPowerDemand;
+        while (limit >= 0x1000000UL) {          // Keep limit x 256 in 32 bits
+            limit >>= 1;
+            demand >>= 1;
+        }
+        scale = (limit << 8) / demand;
+    }
+    if (scale == groupPowerScale) {
+        return false;
+    }
+    groupPowerScale = scale;
+    for (uint8_t i = 0; i < groupLedCount; i++) {
+        groupLeds[i]->writeLed();               // Drives don't change, only outputs
+    }
+    return true;
+}
+#endif
+
+/*!
+
+	\brief	Loop
+
+	Loop part of class. Should be called in loop().
+
+	Returned value may be used to sleep (using delay(), light sleep, vTaskDelay()...) until next change.
+
+	\return	time before next change of any LED in group (in ms), FF_LED_WAIT_FOR_EVER if no LED will ever change
+
+*/
+unsigned long FF_LED_IRAM_ATTR FF_LEDGroup::loop(void) {
+    #ifdef FF_LED_BRIGHTNESS
+        if (groupBrightnessSerial != FF_LED::ledBrightnessSerial) {
+            groupBrightnessSerial = FF_LED::ledBrightnessSerial;
+            groupChanged = true;                // Scan all LEDs, so that they write new output
+        }
+    #endif
+    #ifdef FF_LED_POWER_BUDGET
+        if (updatePowerScale()) {               // Total changed by setters
+            groupChanged = true;                // Scan, so that drivers are flushed
+        }
+    #endif
+    if (!groupChanged && groupWaitTime == FF_LED_WAIT_FOR_EVER) {
+        return FF_LED_WAIT_FOR_EVER;            // All LEDs idle, don't even read clock
+    }
+    unsigned long now = millis();               // Read clock only once
+    unsigned long elapsed = (uint32_t) (now - groupLastTime); // Wraps with millis(), even where unsigned long is 64 bits
+    if (!groupChanged && elapsed < groupWaitTime) {
+        if (groupWaitTime == FF_LED_WAIT_FOR_EVER) {
+            return FF_LED_WAIT_FOR_EVER;
+        }
+        return groupWaitTime - elapsed;         // Nothing due yet
+    }
+    if (elapsed < groupFramePeriod) {
+        return groupFramePeriod - elapsed;      // Changes are run at frame end
+    }
+    groupChanged = false;                       // Changes done by callbacks during scan force next one
+    unsigned long waitTime = FF_LED_WAIT_FOR_EVER;
+    for (uint8_t i = 0; i < groupLedCount; i++) {
+        FF_LED *led = groupLeds[i];
+        if (groupFramePeriod) {
+            led->loopFrame(now);                // Run all changes due during frame, write once
+        } else {
+            led->loop(now);
+        }
+        unsigned long ledWait = led->nextChangeIn(now);
+        if (ledWait < waitTime) {
+            waitTime = ledWait;                 // Keep earliest change
+        }
+    }
+    #ifdef FF_LED_POWER_BUDGET
+        updatePowerScale();                     // Total changed by this scan
+    #endif
+    for (uint8_t i = 0; i < groupLedCount; i++) {
+        FF_LEDOutput *driver = groupLeds[i]->ledDriver;
+        if (driver) {
+            driver->flush();                    // One transaction per driver (does nothing if already sent)
+        }
+    }
+    if (waitTime < groupFramePeriod) {
+        waitTime = groupFramePeriod;            // Next scan at next frame
+    }
+    groupLastTime = now;
+    groupWaitTime = waitTime;
+    return waitTime;
+}
+
+#ifdef FF_LED_TIMER_DRIVEN
+/*!
+
+	\brief	Timer loop
+
+	Loop part of class, to be called from a timer interrupt (or Ticker callback) instead of loop().
+
+	Whole scan is run in a critical section: LEDs of group should be direct pin LEDs switched fully
+	on or off (levels 0 and FF_LED_MAX_LEVEL only, written by digitalWrite()) without callback
+	(no output driver, no setCallback()), as analogWrite(), bus transactions and user code can't run there.
+
+	\return	none
+
+*/
+void FF_LED_IRAM_ATTR FF_LEDGroup::timerLoop(void) {
+    FF_LED_ENTER_CRITICAL_ISR();                // Protect states against setters running on another core
+    loop();
+    FF_LED_EXIT_CRITICAL_ISR();
+}
+
+#ifdef FF_LED_HAS_TICKER
+/*!
+
+	\brief	Start timer
+
+	Start a Ticker running group's state machines. Sketch should then stop calling loop().
+
+	\param[in]	_periodMs: Ticker period (in ms, default to 1)
+	\return	none
+
+*/
+void FF_LEDGroup::beginTimer(uint32_t _periodMs) {
+    groupTicker.attach_ms(_periodMs, timerCallback, this);
+}
+
+/*!
+
+	\brief	Stop timer
+
+	Stop Ticker started by beginTimer(). Sketch should then call loop() again.
+
+	\return	none
+
+*/
+void FF_LEDGroup::endTimer(void) {
+    groupTicker.detach();
+}
+
+/*!
+
+	\brief	Ticker callback
+
+	\param[in]	_group: group to run
+	\return	none
+
+*/
+void FF_LEDGroup::timerCallback(FF_LEDGroup *_group) {
+    _group->timerLoop();
+}
+#endif
+#endif
@@ -0,0 +1,80 @@
+/*!
+	\file
+	\brief	Manage a group of FF_LED with a single scheduler
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Have a look at FF_LEDGroup.cpp for details
+
+*/
+
+
+#ifndef FF_LEDGroup_h
+    #define FF_LEDGroup_h
+    #include "FF_LED.h"
+    #if defined(FF_LED_TIMER_DRIVEN) && (defined(ESP32) || defined(ESP8266))
+        #include <Ticker.h>
+        #define FF_LED_HAS_TICKER                               //!< Group can start its own Ticker
+    #endif
+
+    #ifdef __cplusplus
+        class FF_LEDGroup {
+            /*!	\class FF_LEDGroup
+                \brief Manage a group of FF_LED, reading clock once and scanning LEDs only when one is due
+            */
+            public:
+                FF_LEDGroup(FF_LED **_leds, uint8_t _maxLeds);
+                bool add(FF_LED *_led);
+                bool remove(FF_LED *_led);
+                void begin(void);
+                unsigned long loop(void);
+                uint8_t count(void);
+                void setFrameRate(uint16_t _framesPerSecond);
+                uint8_t saveState(FF_LED::ledStateType *_states, uint8_t _maxStates);
+                uint8_t restoreState(const FF_LED::ledStateType *_states, uint8_t _stateCount);
+                #ifdef FF_LED_POWER_BUDGET
+                    void setPowerBudget(uint16_t _budget);
+                    void setPowerWeight(FF_LED *_led, uint16_t _weight);
+                    uint32_t getPowerDemand(void);
+                #endif
+                #ifdef FF_LED_TIMER_DRIVEN
+                    void timerLoop(void);
+                    #ifdef FF_LED_HAS_TICKER
+                        void beginTimer(uint32_t _periodMs = 1);
+                        void endTimer(void);
+                    #endif
+                #endif
+            private:
+                friend class FF_LED;
+                void ledChanged(void);
+                #ifdef FF_LED_POWER_BUDGET
+                    void powerDemand(FF_LED *_led, FF_LEDCore::ledLevelType _output);
+                    FF_LEDCore::ledLevelType powerScale(FF_LEDCore::ledLevelType _output);
+                    bool updatePowerScale(void);
+                #endif
+                #ifdef FF_LED_HAS_TICKER
+                    static void timerCallback(FF_LEDGroup *_group);
+                #endif
+
+                FF_LED **groupLeds = nullptr;                   //!< LED table (given by caller)
+                uint8_t groupMaxLeds = 0;                       //!< Size of LED table
+                uint8_t groupLedCount = 0;                      //!< Count of LEDs in group
+                bool groupChanged = true;                       //!< One LED changed outside of group loop
+                #ifdef FF_LED_BRIGHTNESS
+                    uint8_t groupBrightnessSerial = 0;          //!< Global brightness serial at last scan
+                #endif
+                #ifdef FF_LED_POWER_BUDGET
+                    uint32_t groupPowerLimit = 0;               //!< Budget, in LED drive unit (weight x 8 bits output, 0 for no limit)
+                    uint32_t groupPowerDemand = 0;              //!< Sum of drives requested by LEDs of group
+                    uint16_t groupPowerScale = 256;             //!< Output scale applied to all LEDs (256 for full output)
+                    bool groupPowerChanged = false;             //!< Demand changed since scale was computed
+                #endif
+                unsigned long groupLastTime = 0;                //!< Last time group was scanned
+                unsigned long groupWaitTime = 0;                //!< Time to wait after last scan before next LED change
+                uint16_t groupFramePeriod = 0;                  //!< Minimum time between two scans (in ms, 0 for no limit)
+                #ifdef FF_LED_HAS_TICKER
+                    Ticker groupTicker;                         //!< Ticker running timerLoop()
+                #endif
+        };
+    #endif
+#endif
@@ -0,0 +1,55 @@
+/*!
+	\file
+	\brief	Output driver interface used by FF_LED for LEDs not connected to a native pin
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	A driver owns several channels (shift register outputs, PWM driver channels...).
+	FF_LED calls write() to stage a channel value, then flush() sends all staged values
+	in one bus transaction. When LEDs are in a FF_LEDGroup, group flushes drivers once
+	per loop, after all due LEDs have been updated.
+
+	Driver should be started (begin()) in setup(), before starting LEDs.
+
+*/
+
+
+#ifndef FF_LEDOutput_h
+    #define FF_LEDOutput_h
+    #include "FF_LED.h"
+
+    #ifdef __cplusplus
+        class FF_LEDOutput {
+            /*!	\class FF_LEDOutput
+                \brief Output driver interface (write staged values, flush them in one transaction)
+            */
+            public:
+                virtual ~FF_LEDOutput() {}
+                virtual void begin(void) = 0;                   //!< Start driver (should be called in setup())
+                /*!
+                    \brief	Stage a channel value
+                    \param[in]	_channel: driver channel
+                    \param[in]	_value: value to write (0-FF_LED_MAX_LEVEL, already inverted if needed)
+                */
+                virtual void write(uint8_t _channel, FF_LEDCore::ledLevelType _value) = 0;
+                /*!
+                    \brief	Send staged values (if any changed) in one transaction
+                */
+                void flush(void) {
+                    if (outputDirty) {
+                        outputDirty = false;
+                        send();
+                    }
+                }
+                /*!
+                    \brief	Is there any staged value not yet sent?
+                */
+                bool isDirty(void) {
+                    return outputDirty;
+                }
+            protected:
+                virtual void send(void) = 0;                    //!< Send all staged values to chip(s)
+                bool outputDirty = false;                       //!< Some staged values are not yet sent
+        };
+    #endif
+#endif
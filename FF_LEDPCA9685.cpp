@@ -0,0 +1,164 @@
+/*!
+	\file
+	\brief	PCA9685 16 channels PWM driver for FF_LED
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Values are converted to PCA9685 12 bits resolution. Only the range of channels changed
+	since last send is written, using register auto increment, so one loop of a group gives
+	one I2C burst per chip. Burst is split only if it doesn't fit in Wire buffer.
+
+		FF_LEDPCA9685 pwmDriver(0x40);
+		FF_LED led0(&pwmDriver, 0);
+*/
+
+#include "FF_LEDPCA9685.h"
+
+#define PCA9685_MODE1 0x00                      // Mode register 1
+#define PCA9685_MODE2 0x01                      // Mode register 2
+#define PCA9685_LED0_ON_L 0x06                  // First channel register
+#define PCA9685_PRESCALE 0xFE                   // PWM frequency prescaler
+#define PCA9685_MODE1_SLEEP 0x10                // Oscillator off
+#define PCA9685_MODE1_AI 0x20                   // Register auto increment
+#define PCA9685_MODE1_RESTART 0x80              // Restart PWM channels
+#define PCA9685_MODE2_OUTDRV 0x04               // Totem pole outputs
+#define PCA9685_FULL 0x1000                     // Full on/off bit in ON_H/OFF_H registers
+#define PCA9685_OSCILLATOR 25000000UL           // Internal oscillator frequency
+
+#if defined(BUFFER_LENGTH)
+    #define PCA9685_WIRE_BUFFER BUFFER_LENGTH
+#elif defined(I2C_BUFFER_LENGTH)
+    #define PCA9685_WIRE_BUFFER I2C_BUFFER_LENGTH
+#else
+    #define PCA9685_WIRE_BUFFER 32
+#endif
+#define PCA9685_CHANNELS_PER_BURST ((PCA9685_WIRE_BUFFER - 1) / 4) // Register address + 4 bytes per channel
+
+/*!
+
+	\brief	Class constructor
+
+	Initialize the class
+
+	\param[in]	_address: chip I2C address (default to 0x40)
+	\param[in]	_wire: I2C bus (default to Wire)
+	\param[in]	_frequency: PWM frequency (in Hz, 24 to 1526, default to 1000)
+	\param[in]	_openDrain: set to true for open drain outputs (default to totem pole)
+	\return	none
+
+*/
+FF_LEDPCA9685::FF_LEDPCA9685(uint8_t _address, TwoWire *_wire, uint16_t _frequency, bool _openDrain) {
+    pcaAddress = _address;
+    pcaWire = _wire;
+    pcaFrequency = _frequency;
+    pcaOpenDrain = _openDrain;
+}
+
+/*!
+
+	\brief	Start driver
+
+	Set PWM frequency, outputs mode and clear all channels. Should be called in setup(), after Wire.begin().
+
+	\return	none
+
+*/
+void FF_LEDPCA9685::begin(void) {
+    uint32_t prescale = (PCA9685_OSCILLATOR + (2048UL * pcaFrequency)) / (4096UL * pcaFrequency) - 1;
+    if (prescale < 3) {
+        prescale = 3;
+    } else if (prescale > 255) {
+        prescale = 255;
+    }
+    writeRegister(PCA9685_MODE1, PCA9685_MODE1_SLEEP);  // Prescaler can only be set when sleeping
+    writeRegister(PCA9685_PRESCALE, prescale);
+    writeRegister(PCA9685_MODE2, pcaOpenDrain ? 0 : PCA9685_MODE2_OUTDRV);
+    writeRegister(PCA9685_MODE1, PCA9685_MODE1_AI); // Wake up with auto increment
+    delayMicroseconds(500);                     // Oscillator start time
+    writeRegister(PCA9685_MODE1, PCA9685_MODE1_AI | PCA9685_MODE1_RESTART);
+    pcaFirstDirty = 0;                          // Force initial state
+    pcaLastDirty = FF_LED_PCA9685_CHANNELS - 1;
+    outputDirty = true;
+    flush();
+}
+
+/*!
+
+	\brief	Stage a channel value
+
+	\param[in]	_channel: channel number (0-15)
+	\param[in]	_value: value to write (0-FF_LED_MAX_LEVEL, already inverted if needed)
+	\return	none
+
+*/
+void FF_LEDPCA9685::write(uint8_t _channel, FF_LEDCore::ledLevelType _value) {
+    if (_channel >= FF_LED_PCA9685_CHANNELS) {
+        return;
+    }
+    #if FF_LED_LEVEL_BITS >= 12
+        uint16_t value = _value >> (FF_LED_LEVEL_BITS - 12);
+    #else
+        uint16_t value = (_value == FF_LED_MAX_LEVEL) ? 4095 : _value << (12 - FF_LED_LEVEL_BITS);
+    #endif
+    if (value == pcaValues[_channel]) {
+        return;
+    }
+    pcaValues[_channel] = value;
+    if (_channel < pcaFirstDirty) {
+        pcaFirstDirty = _channel;
+    }
+    if (_channel > pcaLastDirty) {
+        pcaLastDirty = _channel;
+    }
+    outputDirty = true;
+}
+
+/*!
+
+	\brief	Send staged values
+
+	Write changed channels range in one auto increment burst
+
+	\return	none
+
+*/
+void FF_LEDPCA9685::send(void) {
+    uint8_t channel = pcaFirstDirty;
+    while (channel <= pcaLastDirty) {
+        pcaWire->beginTransmission(pcaAddress);
+        pcaWire->write(PCA9685_LED0_ON_L + (4 * channel));
+        for (uint8_t i = 0; i < PCA9685_CHANNELS_PER_BURST && channel <= pcaLastDirty; i++, channel++) {
+            uint16_t on = 0;
+            uint16_t off = pcaValues[channel];
+            if (off == 0) {
+                off = PCA9685_FULL;             // Full off
+            } else if (off >= 4095) {
+                on = PCA9685_FULL;              // Full on
+                off = 0;
+            }
+            pcaWire->write(on & 0xFF);
+            pcaWire->write(on >> 8);
+            pcaWire->write(off & 0xFF);
+            pcaWire->write(off >> 8);
+        }
+        pcaWire->endTransmission();
+    }
+    pcaFirstDirty = FF_LED_PCA9685_CHANNELS;    // Nothing dirty anymore
+    pcaLastDirty = 0;
+}
+
+/*!
+
+	\brief	Write one chip register
+
+	\param[in]	_register: register address
+	\param[in]	_value: value to write
+	\return	none
+
+*/
+void FF_LEDPCA9685::writeRegister(uint8_t _register, uint8_t _value) {
+    pcaWire->beginTransmission(pcaAddress);
+    pcaWire->write(_register);
+    pcaWire->write(_value);
+    pcaWire->endTransmission();
+}
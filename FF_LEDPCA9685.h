@@ -0,0 +1,40 @@
+/*!
+	\file
+	\brief	PCA9685 16 channels PWM driver for FF_LED
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Have a look at FF_LEDPCA9685.cpp for details
+
+*/
+
+
+#ifndef FF_LEDPCA9685_h
+    #define FF_LEDPCA9685_h
+    #include "FF_LEDOutput.h"
+    #include <Wire.h>
+
+    #ifdef __cplusplus
+        #define FF_LED_PCA9685_CHANNELS 16                      //!< Count of PCA9685 channels
+        class FF_LEDPCA9685 : public FF_LEDOutput {
+            /*!	\class FF_LEDPCA9685
+                \brief PCA9685 driven by I2C, changed channels sent in one burst write
+            */
+            public:
+                FF_LEDPCA9685(uint8_t _address = 0x40, TwoWire *_wire = &Wire, uint16_t _frequency = 1000, bool _openDrain = false);
+                void begin(void) override;
+                void write(uint8_t _channel, FF_LEDCore::ledLevelType _value) override;
+            protected:
+                void send(void) override;
+                void writeRegister(uint8_t _register, uint8_t _value);
+
+                TwoWire *pcaWire = nullptr;                     //!< I2C bus
+                uint8_t pcaAddress = 0x40;                      //!< Chip I2C address
+                uint16_t pcaFrequency = 1000;                   //!< PWM frequency (in Hz)
+                bool pcaOpenDrain = false;                      //!< Are outputs open drain (else totem pole)?
+                uint8_t pcaFirstDirty = FF_LED_PCA9685_CHANNELS; //!< First channel changed since last send
+                uint8_t pcaLastDirty = 0;                       //!< Last channel changed since last send
+                uint16_t pcaValues[FF_LED_PCA9685_CHANNELS] = {0}; //!< Channel values (12 bits)
+        };
+    #endif
+#endif
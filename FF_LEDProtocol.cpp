@@ -0,0 +1,228 @@
+/*!
+	\file
+	\brief	Decode compact binary LED commands (from MQTT, serial, ESP-NOW...) into FF_LED effects
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Instead of parsing a JSON message for each indication change, a server sends small binary
+	frames. Decoder reads them in place (no copy, no allocation) and calls setters of LEDs
+	(or posts them to a FF_LEDService, when changes are received by another task).
+
+	LEDs are known by their index in a table given by caller:
+
+		FF_LED *myLeds[] = {&statusLed, &wifiLed, &errorLed};
+		FF_LEDProtocol myProtocol(myLeds, 3);
+
+		void onMqttMessage(char *topic, byte *payload, unsigned int length) {
+			myProtocol.decode(payload, length);
+		}
+
+	A frame starts with its count of commands (any count, giving batch updates for many LEDs),
+	followed by commands. All values are unsigned, 16 bits values are little endian, levels are
+	sent on 8 bits (0-255, scaled to FF_LED_MAX_LEVEL):
+
+		byte 0      LED id (index in table, FF_LED_PROTOCOL_ALL_LEDS for all LEDs)
+		byte 1      mode (FF_LEDCore::ledModedType, bits 0-2) and flags (FF_LED_PROTOCOL_xxx, bits 3-7)
+		fixed       byte 2: level (3 bytes)
+		blink       byte 2: blink count, 3-4: on time, 5-6: off time, 7-8: wait time, 9: min level, 10: max level (11 bytes)
+		pulse       bytes 2-3: up time, 4-5: down time, 6-7: wait time, 8: min level, 9: max level (10 bytes)
+		timedPulse  same as pulse
+		+ cycles    when FF_LED_PROTOCOL_CYCLES is set: cycle count, final level (2 more bytes)
+
+	Times are in ms, or in 100 ms units (up to 109 minutes) when FF_LED_PROTOCOL_DECISECONDS is set.
+	As an example, blinking LED 1 twice (100 ms on, 200 ms off), then waiting 2 seconds, is:
+
+		01  01 01  02  64 00  C8 00  D0 07  00 FF
+
+	Sequences are not available, as their steps are tables in firmware.
+*/
+
+#include "FF_LEDProtocol.h"
+
+/*!
+
+	\brief	Class constructor
+
+	Initialize the class, commands calling LED setters
+
+	\param[in]	_leds: table of LEDs, indexed by LED id
+	\param[in]	_ledCount: size of _leds table
+	\return	none
+
+*/
+FF_LEDProtocol::FF_LEDProtocol(FF_LED **_leds, uint8_t _ledCount) {
+    protocolLeds = _leds;
+    protocolLedCount = _ledCount;
+}
+
+#ifdef FF_LED_HAS_SERVICE
+/*!
+
+	\brief	Class constructor
+
+	Initialize the class, commands being posted to a service (frames may then be decoded by any task)
+
+	\param[in]	_service: service running LEDs
+	\param[in]	_leds: table of LEDs, indexed by LED id (should be in service's group)
+	\param[in]	_ledCount: size of _leds table
+	\return	none
+
+*/
+FF_LEDProtocol::FF_LEDProtocol(FF_LEDService *_service, FF_LED **_leds, uint8_t _ledCount) {
+    protocolService = _service;
+    protocolLeds = _leds;
+    protocolLedCount = _ledCount;
+}
+#endif
+
+/*!
+
+	\brief	Decode a frame
+
+	Decode and apply all commands of a frame. Decoding stops at first invalid or truncated command.
+
+	\param[in]	_frame: frame to decode
+	\param[in]	_length: length of frame (in bytes)
+	\return	count of commands decoded
+
+*/
+uint8_t FF_LEDProtocol::decode(const uint8_t *_frame, size_t _length) {
+    if (!_frame || !_length) {
+        return 0;
+    }
+    const uint8_t *end = _frame + _length;
+    const uint8_t *data = _frame + 1;
+    uint8_t decoded = 0;
+    for (uint8_t count = _frame[0]; decoded < count; decoded++) {
+        data = decodeCommand(data, end);
+        if (!data) {
+            break;
+        }
+    }
+    return decoded;
+}
+
+/*!
+
+	\brief	Decode a command
+
+	\param[in]	_data: start of command
+	\param[in]	_end: end of frame
+	\return	start of next command, nullptr if command is invalid or truncated
+
+*/
+const uint8_t *FF_LEDProtocol::decodeCommand(const uint8_t *_data, const uint8_t *_end) {
+    if (_end - _data < 2) {
+        return nullptr;
+    }
+    uint8_t id = _data[0];
+    uint8_t flags = _data[1];
+    uint8_t mode = flags & 0x07;
+    size_t length;
+    switch (mode) {
+        case FF_LEDCore::fixed:
+            length = 3;
+            break;
+        case FF_LEDCore::blink:
+            length = 11;
+            break;
+        case FF_LEDCore::pulse:
+        case FF_LEDCore::timedPulse:
+            length = 10;
+            break;
+        default:
+            return nullptr;                     // Sequences and unknown modes
+    }
+    if (flags & FF_LED_PROTOCOL_CYCLES) {
+        length += 2;
+    }
+    if ((size_t) (_end - _data) < length || (id >= protocolLedCount && id != FF_LED_PROTOCOL_ALL_LEDS)) {
+        return nullptr;
+    }
+    const uint8_t *times = _data + (mode == FF_LEDCore::blink ? 3 : 2); // Blink count comes first
+    uint8_t count = (mode == FF_LEDCore::blink) ? _data[2] : (flags & FF_LED_PROTOCOL_INCREASE) != 0;
+    unsigned long unit = (flags & FF_LED_PROTOCOL_DECISECONDS) ? 100 : 1;
+    unsigned long time0 = 0, time1 = 0, time2 = 0;
+    ledLevelType minLevel, maxLevel;
+    if (mode == FF_LEDCore::fixed) {
+        minLevel = maxLevel = readLevel(_data + 2);
+    } else {
+        time0 = read16(times) * unit;
+        time1 = read16(times + 2) * unit;
+        time2 = read16(times + 4) * unit;
+        minLevel = readLevel(times + 6);
+        maxLevel = readLevel(times + 7);
+    }
+    uint8_t cycleCount = 0;
+    ledLevelType finalLevel = 0;
+    if (flags & FF_LED_PROTOCOL_CYCLES) {
+        cycleCount = _data[length - 2];
+        finalLevel = readLevel(_data + length - 1);
+    }
+    if (id == FF_LED_PROTOCOL_ALL_LEDS) {
+        for (uint8_t i = 0; i < protocolLedCount; i++) {
+            apply(protocolLeds[i], mode, count, time0, time1, time2, minLevel, maxLevel, cycleCount, finalLevel);
+        }
+    } else {
+        apply(protocolLeds[id], mode, count, time0, time1, time2, minLevel, maxLevel, cycleCount, finalLevel);
+    }
+    return _data + length;
+}
+
+/*!
+
+	\brief	Apply a decoded command to a LED
+
+	Call LED setter, or post it to service
+
+	\param[in]	_led: LED to change
+	\param[in]	_mode: effect to set (FF_LEDCore::ledModedType)
+	\param[in]	_count: blink count or pulse increase
+	\param[in]	_time0: on/up time (in ms)
+	\param[in]	_time1: off/down time (in ms)
+	\param[in]	_time2: wait time (in ms)
+	\param[in]	_minLevel: minimum level (level for fixed)
+	\param[in]	_maxLevel: maximum level
+	\param[in]	_cycleCount: count of cycles before LED stops (0 for ever)
+	\param[in]	_finalLevel: level kept after last cycle
+	\return	none
+
+*/
+void FF_LEDProtocol::apply(FF_LED *_led, uint8_t _mode, uint8_t _count, unsigned long _time0, unsigned long _time1, unsigned long _time2, ledLevelType _minLevel, ledLevelType _maxLevel, uint8_t _cycleCount, ledLevelType _finalLevel) {
+    if (!_led) {
+        return;
+    }
+    #ifdef FF_LED_HAS_SERVICE
+        if (protocolService) {
+            switch (_mode) {
+                case FF_LEDCore::fixed:
+                    protocolService->setFixed(_led, _minLevel);
+                    break;
+                case FF_LEDCore::blink:
+                    protocolService->setBlink(_led, _count, _time0, _time1, _time2, _minLevel, _maxLevel, _cycleCount, _finalLevel);
+                    break;
+                case FF_LEDCore::pulse:
+                    protocolService->setPulse(_led, _count, _time0, _time1, _time2, _minLevel, _maxLevel, _cycleCount, _finalLevel);
+                    break;
+                case FF_LEDCore::timedPulse:
+                    protocolService->setTimedPulse(_led, _count, _time0, _time1, _time2, _minLevel, _maxLevel, _cycleCount, _finalLevel);
+                    break;
+            }
+            return;
+        }
+    #endif
+    switch (_mode) {
+        case FF_LEDCore::fixed:
+            _led->setFixed(_minLevel);
+            break;
+        case FF_LEDCore::blink:
+            _led->setBlink(_count, _time0, _time1, _time2, _minLevel, _maxLevel, _cycleCount, _finalLevel);
+            break;
+        case FF_LEDCore::pulse:
+            _led->setPulse(_count, _time0, _time1, _time2, _minLevel, _maxLevel, _cycleCount, _finalLevel);
+            break;
+        case FF_LEDCore::timedPulse:
+            _led->setTimedPulse(_count, _time0, _time1, _time2, _minLevel, _maxLevel, _cycleCount, _finalLevel);
+            break;
+    }
+}
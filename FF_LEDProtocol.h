@@ -0,0 +1,49 @@
+/*!
+	\file
+	\brief	Decode compact binary LED commands (from MQTT, serial, ESP-NOW...) into FF_LED effects
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Have a look at FF_LEDProtocol.cpp for details
+
+*/
+
+
+#ifndef FF_LEDProtocol_h
+    #define FF_LEDProtocol_h
+    #include "FF_LED.h"
+    #include "FF_LEDService.h"
+
+    #define FF_LED_PROTOCOL_ALL_LEDS 255                        //!< LED id applying a command to all LEDs of table
+    #define FF_LED_PROTOCOL_INCREASE 0x08                       //!< Flag: pulse starts increasing
+    #define FF_LED_PROTOCOL_CYCLES 0x10                         //!< Flag: cycle count and final level follow
+    #define FF_LED_PROTOCOL_DECISECONDS 0x20                    //!< Flag: times are in 100 ms units
+
+    #ifdef __cplusplus
+        class FF_LEDProtocol {
+            /*!	\class FF_LEDProtocol
+                \brief Decode binary command frames, calling FF_LED setters (or posting them to a FF_LEDService)
+            */
+            public:
+                FF_LEDProtocol(FF_LED **_leds, uint8_t _ledCount);
+                #ifdef FF_LED_HAS_SERVICE
+                    FF_LEDProtocol(FF_LEDService *_service, FF_LED **_leds, uint8_t _ledCount);
+                #endif
+                uint8_t decode(const uint8_t *_frame, size_t _length);
+            private:
+                typedef FF_LEDCore::ledLevelType ledLevelType;  //!< LED level definition
+                const uint8_t *decodeCommand(const uint8_t *_data, const uint8_t *_end);
+                void apply(FF_LED *_led, uint8_t _mode, uint8_t _count, unsigned long _time0, unsigned long _time1, unsigned long _time2, ledLevelType _minLevel, ledLevelType _maxLevel, uint8_t _cycleCount, ledLevelType _finalLevel);
+                /*! \brief Read a little endian 16 bits value */
+                static inline uint16_t read16(const uint8_t *_data) {return _data[0] | (_data[1] << 8);}
+                /*! \brief Convert a 8 bits wire level to LED level */
+                static inline ledLevelType readLevel(const uint8_t *_data) {return ((uint32_t) _data[0] * FF_LED_MAX_LEVEL) / 255;}
+
+                FF_LED **protocolLeds = nullptr;                //!< LED table, indexed by LED id (given by caller)
+                uint8_t protocolLedCount = 0;                   //!< Size of LED table
+                #ifdef FF_LED_HAS_SERVICE
+                    FF_LEDService *protocolService = nullptr;   //!< Service commands are posted to (nullptr to call setters)
+                #endif
+        };
+    #endif
+#endif
@@ -0,0 +1,337 @@
+/*!
+	\file
+	\brief	Run a group of FF_LED from a dedicated FreeRTOS task, fed by a lock-free command queue (ESP32)
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	When effects are changed from several tasks (MQTT, sensors, web server...), calling FF_LED setters
+	directly would race with loop() running on main task. Service starts one (low priority) task
+	owning all LEDs of a group: this task is the only one running state machines and setters.
+
+	Other tasks post effect changes to service, using the same parameters as FF_LED setters.
+	Changes are stored in a bounded multi producer/single consumer queue, using only atomic operations
+	(no mutex nor critical section). Task applies posted changes, runs group and then sleeps until next
+	LED change is due or a new change is posted.
+
+	Queue slots are given by caller (count should be a power of 2, it is rounded down otherwise):
+
+		FF_LED *myLeds[8];
+		FF_LEDGroup myGroup(myLeds, 8);
+		FF_LEDService::ledCommandType myCommands[16];
+		FF_LEDService myService(&myGroup, myCommands, 16);
+
+		myGroup.add(&statusLed);
+		myService.begin();                      // Starts LEDs of group, then task
+		myService.setBlink(&statusLed, 2, 100, 100, 1000); // From any task
+
+	Once service is started, sketch shouldn't call loop() nor setters of group's LEDs anymore.
+	Changes are posted from tasks only (not from interrupts).
+*/
+
+#include "FF_LEDService.h"
+
+#ifdef FF_LED_HAS_SERVICE
+/*!
+
+	\brief	Class constructor
+
+	Initialize the class
+
+	\param[in]	_group: group of LEDs to be run by service task
+	\param[in]	_commands: table of command slots to be used by queue
+	\param[in]	_maxCommands: size of _commands table (power of 2, rounded down otherwise)
+	\return	none
+
+*/
+FF_LEDService::FF_LEDService(FF_LEDGroup *_group, ledCommandType *_commands, uint16_t _maxCommands) {
+    while (_maxCommands & (_maxCommands - 1)) { // Keep highest bit only
+        _maxCommands &= _maxCommands - 1;
+    }
+    serviceGroup = _group;
+    serviceCommands = _maxCommands ? _commands : nullptr;
+    serviceMask = _maxCommands - 1;
+    for (uint16_t i = 0; i < _maxCommands; i++) {
+        serviceCommands[i].commandSequence.store(i, std::memory_order_relaxed); // Slot i is free for position i
+    }
+    serviceWritePos.store(0, std::memory_order_relaxed);
+    serviceLost.store(0, std::memory_order_relaxed);
+}
+
+/*!
+
+	\brief	Start service
+
+	Start all LEDs in group (replaces group's begin()), then task running them. Should be called in setup().
+
+	\param[in]	_priority: task priority (default to 1, just above idle task)
+	\param[in]	_stackSize: task stack size (in bytes, default to 2048)
+	\param[in]	_core: core to run task on (default to any)
+	\return	true if task started, false if task couldn't be created or queue has no slot
+
+*/
+bool FF_LEDService::begin(UBaseType_t _priority, uint32_t _stackSize, BaseType_t _core) {
+    if (serviceTask) {
+        return true;                            // Already running
+    }
+    if (!serviceCommands) {
+        return false;                           // No queue slot, task couldn't read any command
+    }
+    serviceGroup->begin();
+    serviceRunning = true;
+    TaskHandle_t task = nullptr;
+    if (xTaskCreatePinnedToCore(taskEntry, "FF_LED", _stackSize, this, _priority, &task, _core) != pdPASS) {
+        serviceRunning = false;
+        return false;
+    }
+    serviceTask = task;
+    return true;
+}
+
+/*!
+
+	\brief	Stop service
+
+	Ask task to stop and wait for it. Changes still in queue are applied when service is started again.
+	Should not be called while other tasks post changes.
+
+	\return	none
+
+*/
+void FF_LEDService::end(void) {
+    if (!serviceTask) {
+        return;
+    }
+    serviceRunning = false;
+    xTaskNotifyGive(serviceTask);               // Wake task up
+    while (serviceTask) {                       // Task clears handle before deleting itself
+        vTaskDelay(1);
+    }
+}
+
+/*!
+
+	\brief	Post a fixed level
+
+	Post a setFixed() call (see FF_LED::setFixed())
+
+	\param[in]	_led: LED to change (should be in service's group)
+	\return	true if change posted, false if queue is full
+
+*/
+bool FF_LEDService::setFixed(FF_LED *_led, ledLevelType _level) {
+    return post(_led, FF_LEDCore::fixed, 0, 0, 0, 0, _level, _level);
+}
+
+/*!
+
+	\brief	Post a blink sequence
+
+	Post a setBlink() call (see FF_LEDCore::setBlink())
+
+	\param[in]	_led: LED to change (should be in service's group)
+	\return	true if change posted, false if queue is full
+
+*/
+bool FF_LEDService::setBlink(FF_LED *_led, uint8_t _blinkCount, unsigned long _onTime, unsigned long _offTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel, uint8_t _cycleCount, ledLevelType _finalLevel) {
+    return post(_led, FF_LEDCore::blink, _blinkCount, _onTime, _offTime, _waitTime, _minLevel, _maxLevel, _cycleCount, _finalLevel);
+}
+
+/*!
+
+	\brief	Post a continous pulse
+
+	Post a setPulse() call (see FF_LEDCore::setPulse())
+
+	\param[in]	_led: LED to change (should be in service's group)
+	\return	true if change posted, false if queue is full
+
+*/
+bool FF_LEDService::setPulse(FF_LED *_led, bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel, uint8_t _cycleCount, ledLevelType _finalLevel) {
+    return post(_led, FF_LEDCore::pulse, _increase, _upTime, _downTime, _waitTime, _minLevel, _maxLevel, _cycleCount, _finalLevel);
+}
+
+/*!
+
+	\brief	Post a continous time based pulse
+
+	Post a setTimedPulse() call (see FF_LEDCore::setTimedPulse())
+
+	\param[in]	_led: LED to change (should be in service's group)
+	\return	true if change posted, false if queue is full
+
+*/
+bool FF_LEDService::setTimedPulse(FF_LED *_led, bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel, uint8_t _cycleCount, ledLevelType _finalLevel) {
+    return post(_led, FF_LEDCore::timedPulse, _increase, _upTime, _downTime, _waitTime, _minLevel, _maxLevel, _cycleCount, _finalLevel);
+}
+
+/*!
+
+	\brief	Post a sequence
+
+	Post a setSequence() call (see FF_LEDCore::setSequence())
+
+	\param[in]	_led: LED to change (should be in service's group)
+	\return	true if change posted, false if queue is full
+
+*/
+bool FF_LEDService::setSequence(FF_LED *_led, const ledStepType *_steps, uint8_t _stepCount, bool _repeat) {
+    return post(_led, FF_LEDCore::sequence, _stepCount, 0, 0, 0, 0, 0, 0, 0, _steps, _repeat);
+}
+
+/*!
+
+	\brief	Return count of commands lost
+
+	\return	count of changes refused since start because queue was full
+
+*/
+unsigned long FF_LEDService::getCommandsLost(void) {
+    return serviceLost.load(std::memory_order_relaxed);
+}
+
+/*!
+
+	\brief	Post a command
+
+	Reserve a queue slot (a compare and swap on write position, retried only when another task
+	reserved the same slot at the same time), fill it, then publish it and wake task up
+
+	\param[in]	_led: LED to change
+	\param[in]	_mode: effect to set (FF_LEDCore::ledModedType)
+	\param[in]	_count: blink count, pulse increase or step count
+	\param[in]	_time0: on/up time (in ms)
+	\param[in]	_time1: off/down time (in ms)
+	\param[in]	_time2: wait time (in ms)
+	\param[in]	_minLevel: minimum level (level for fixed)
+	\param[in]	_maxLevel: maximum level
+	\param[in]	_cycleCount: count of cycles before LED stops (0 for ever)
+	\param[in]	_finalLevel: level kept after last cycle
+	\param[in]	_steps: sequence steps table (sequence)
+	\param[in]	_repeat: repeat sequence
+	\return	true if command posted, false if queue is full
+
+*/
+bool FF_LEDService::post(FF_LED *_led, uint8_t _mode, uint8_t _count, unsigned long _time0, unsigned long _time1, unsigned long _time2, ledLevelType _minLevel, ledLevelType _maxLevel, uint8_t _cycleCount, ledLevelType _finalLevel, const ledStepType *_steps, bool _repeat) {
+    if (!serviceCommands || !_led) {
+        return false;
+    }
+    uint32_t position = serviceWritePos.load(std::memory_order_relaxed);
+    ledCommandType *command;
+    for (;;) {
+        command = &serviceCommands[position & serviceMask];
+        int32_t difference = (int32_t) (command->commandSequence.load(std::memory_order_acquire) - position);
+        if (difference == 0) {                  // Slot is free, try to reserve it
+            if (serviceWritePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }                                   // Position reloaded by failed exchange
+        } else if (difference < 0) {            // Slot not yet read by task: queue is full
+            serviceLost.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {                                // Slot reserved by another task
+            position = serviceWritePos.load(std::memory_order_relaxed);
+        }
+    }
+    command->led = _led;
+    command->steps = _steps;
+    command->times[0] = _time0;
+    command->times[1] = _time1;
+    command->times[2] = _time2;
+    command->minLevel = _minLevel;
+    command->maxLevel = _maxLevel;
+    command->finalLevel = _finalLevel;
+    command->mode = _mode;
+    command->count = _count;
+    command->cycles = _cycleCount;
+    command->repeat = _repeat;
+    command->commandSequence.store(position + 1, std::memory_order_release); // Publish slot to task
+    TaskHandle_t task = serviceTask;
+    if (task) {
+        xTaskNotifyGive(task);
+    }
+    return true;
+}
+
+/*!
+
+	\brief	Apply one posted command
+
+	Read oldest published slot, free it, then call matching setter of LED (from service task only)
+
+	\return	true if a command was applied, false if queue is empty
+
+*/
+bool FF_LEDService::receive(void) {
+    ledCommandType *slot = &serviceCommands[serviceReadPos & serviceMask];
+    if ((int32_t) (slot->commandSequence.load(std::memory_order_acquire) - (serviceReadPos + 1)) < 0) {
+        return false;                           // Slot not yet published
+    }
+    FF_LED *led = slot->led;                    // Copy command, so that slot can be reused at once
+    const ledStepType *steps = slot->steps;
+    uint32_t time0 = slot->times[0];
+    uint32_t time1 = slot->times[1];
+    uint32_t time2 = slot->times[2];
+    ledLevelType minLevel = slot->minLevel;
+    ledLevelType maxLevel = slot->maxLevel;
+    ledLevelType finalLevel = slot->finalLevel;
+    uint8_t mode = slot->mode;
+    uint8_t count = slot->count;
+    uint8_t cycles = slot->cycles;
+    bool repeat = slot->repeat;
+    slot->commandSequence.store(serviceReadPos + serviceMask + 1, std::memory_order_release); // Free slot for next turn
+    serviceReadPos++;
+    switch (mode) {
+        case FF_LEDCore::fixed:
+            led->setFixed(minLevel);
+            break;
+        case FF_LEDCore::blink:
+            led->setBlink(count, time0, time1, time2, minLevel, maxLevel, cycles, finalLevel);
+            break;
+        case FF_LEDCore::pulse:
+            led->setPulse(count, time0, time1, time2, minLevel, maxLevel, cycles, finalLevel);
+            break;
+        case FF_LEDCore::timedPulse:
+            led->setTimedPulse(count, time0, time1, time2, minLevel, maxLevel, cycles, finalLevel);
+            break;
+        case FF_LEDCore::sequence:
+            led->setSequence(steps, count, repeat);
+            break;
+    }
+    return true;
+}
+
+/*!
+
+	\brief	Service task loop
+
+	Apply posted commands, run group, then sleep until next change or next posted command
+
+	\return	none
+
+*/
+void FF_LEDService::run(void) {
+    while (serviceRunning) {
+        while (receive()) {
+        }
+        unsigned long waitTime = serviceGroup->loop();
+        TickType_t ticks = portMAX_DELAY;
+        if (waitTime != FF_LED_WAIT_FOR_EVER) { // Round up, so that change is due when task wakes up
+            ticks = (waitTime + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+        }
+        ulTaskNotifyTake(pdTRUE, ticks);
+    }
+    serviceTask = nullptr;
+    vTaskDelete(nullptr);
+}
+
+/*!
+
+	\brief	Service task entry
+
+	\param[in]	_service: service to run
+	\return	none
+
+*/
+void FF_LEDService::taskEntry(void *_service) {
+    ((FF_LEDService *) _service)->run();
+}
+#endif
@@ -0,0 +1,67 @@
+/*!
+	\file
+	\brief	Run a group of FF_LED from a dedicated FreeRTOS task, fed by a lock-free command queue (ESP32)
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Have a look at FF_LEDService.cpp for details
+
+*/
+
+
+#ifndef FF_LEDService_h
+    #define FF_LEDService_h
+    #include "FF_LED.h"
+    #include "FF_LEDGroup.h"
+    #if defined(ESP32)
+        #include <atomic>
+        #define FF_LED_HAS_SERVICE                              //!< LED service task is available
+    #endif
+
+    #if defined(__cplusplus) && defined(FF_LED_HAS_SERVICE)
+        class FF_LEDService {
+            /*!	\class FF_LEDService
+                \brief Task owning all LED state machines of a group, other tasks posting effect changes in a queue
+            */
+            public:
+                typedef FF_LEDCore::ledLevelType ledLevelType;  //!< LED level definition
+                typedef FF_LEDCore::ledStepType ledStepType;    //!< Sequence step definition
+                struct ledCommandType {
+                    std::atomic<uint32_t> commandSequence;      //!< Slot sequence (queue internal)
+                    FF_LED *led;                                //!< LED to change
+                    const ledStepType *steps;                   //!< Sequence steps table (sequence)
+                    uint32_t times[3];                          //!< On/up, off/down and wait times (in ms)
+                    ledLevelType minLevel;                      //!< Minimum level (level for fixed)
+                    ledLevelType maxLevel;                      //!< Maximum level
+                    ledLevelType finalLevel;                    //!< Level kept after last cycle
+                    uint8_t mode;                               //!< Effect to set (FF_LEDCore::ledModedType)
+                    uint8_t count;                              //!< Blink count, pulse increase or step count
+                    uint8_t cycles;                             //!< Count of cycles (0 for ever)
+                    bool repeat;                                //!< Repeat sequence
+                };
+                FF_LEDService(FF_LEDGroup *_group, ledCommandType *_commands, uint16_t _maxCommands);
+                bool begin(UBaseType_t _priority = 1, uint32_t _stackSize = 2048, BaseType_t _core = tskNO_AFFINITY);
+                void end(void);
+                bool setFixed(FF_LED *_led, ledLevelType _level);
+                bool setBlink(FF_LED *_led, uint8_t _blinkCount, unsigned long _onTime, unsigned long _offTime, unsigned long _waitTime, ledLevelType _minLevel = 0, ledLevelType _maxLevel = FF_LED_MAX_LEVEL, uint8_t _cycleCount = 0, ledLevelType _finalLevel = 0);
+                bool setPulse(FF_LED *_led, bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel = 0, ledLevelType _maxLevel = FF_LED_MAX_LEVEL, uint8_t _cycleCount = 0, ledLevelType _finalLevel = 0);
+                bool setTimedPulse(FF_LED *_led, bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel = 0, ledLevelType _maxLevel = FF_LED_MAX_LEVEL, uint8_t _cycleCount = 0, ledLevelType _finalLevel = 0);
+                bool setSequence(FF_LED *_led, const ledStepType *_steps, uint8_t _stepCount, bool _repeat = true);
+                unsigned long getCommandsLost(void);
+            private:
+                bool post(FF_LED *_led, uint8_t _mode, uint8_t _count, unsigned long _time0, unsigned long _time1, unsigned long _time2, ledLevelType _minLevel, ledLevelType _maxLevel, uint8_t _cycleCount = 0, ledLevelType _finalLevel = 0, const ledStepType *_steps = nullptr, bool _repeat = false);
+                bool receive(void);
+                void run(void);
+                static void taskEntry(void *_service);
+
+                FF_LEDGroup *serviceGroup = nullptr;            //!< Group run by task
+                ledCommandType *serviceCommands = nullptr;      //!< Command queue slots (given by caller)
+                uint32_t serviceMask = 0;                       //!< Count of slots - 1 (count is a power of 2)
+                std::atomic<uint32_t> serviceWritePos;          //!< Next slot to be reserved by a producer
+                uint32_t serviceReadPos = 0;                    //!< Next slot to be read by task
+                std::atomic<uint32_t> serviceLost;              //!< Count of commands lost because queue was full
+                TaskHandle_t volatile serviceTask = nullptr;    //!< Service task (cleared by task when it stops)
+                volatile bool serviceRunning = false;           //!< Task should keep running
+        };
+    #endif
+#endif
@@ -0,0 +1,351 @@
+/*!
+	\file
+	\brief	Priority layered effects on one FF_LED
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	When several subsystems share one LED (error blink over WiFi pulse over idle level), each one sets
+	its effect with its own priority. Only the highest priority effect runs on LED, lower ones are
+	kept paused in a table. When top effect is released, effect below resumes where it was paused
+	(same level, same remaining delay, time based effects shifted by pause time), without being set again.
+
+	Effect table is given by caller, one slot per priority used at the same time:
+
+		FF_LEDStack::ledSlotType statusSlots[3];
+		FF_LEDStack statusStack(&statusLed, statusSlots, 3);
+
+		statusStack.setFixed(0, 20);            // Idle level
+		statusStack.setPulse(1, true, 4, 4, 500); // WiFi connecting, over idle level
+		statusStack.setBlink(2, 3, 100, 100, 1000); // Error, over everything
+		statusStack.release(2);                 // Error cleared, WiFi pulse resumes
+
+	Setting an effect of a lower priority than top one only updates its slot: it starts when it becomes top.
+	Effects are set on LED with its usual setters, so transition time (if any) applies when a higher
+	priority effect starts. LED should not be changed directly while stack is used.
+*/
+
+#include "FF_LEDStack.h"
+
+/*!
+
+	\brief	Class constructor
+
+	Initialize the class
+
+	\param[in]	_led: LED running effects
+	\param[in]	_slots: table of effect slots to be used by stack
+	\param[in]	_maxSlots: size of _slots table
+	\param[in]	_idleLevel: LED level set when last effect is released (default to 0)
+	\return	none
+
+*/
+FF_LEDStack::FF_LEDStack(FF_LED *_led, ledSlotType *_slots, uint8_t _maxSlots, ledLevelType _idleLevel) {
+    stackLed = _led;
+    stackSlots = _slots;
+    stackMaxSlots = _maxSlots;
+    stackIdleLevel = _idleLevel;
+}
+
+/*!
+
+	\brief	Set a fixed level at a given priority
+
+	\param[in]	_priority: effect priority (higher wins)
+	\param[in]	_level: LED level to set (0-FF_LED_MAX_LEVEL)
+	\return	true if effect set, false if table is full
+
+*/
+bool FF_LEDStack::setFixed(uint8_t _priority, ledLevelType _level) {
+    ledSlotType *slot = prepare(_priority);
+    if (!slot) {
+        return false;
+    }
+    if (isTop(slot)) {
+        stackLed->setFixed(_level);
+    } else {
+        FF_LED_ENTER_CRITICAL();
+        slot->setFixed(_level);
+        slot->slotCyclesLeft = 0;
+        slot->slotPausedAt = slot->ledLastTimeChanged;
+        FF_LED_EXIT_CRITICAL();
+    }
+    return true;
+}
+
+/*!
+
+	\brief	Set a blink sequence at a given priority
+
+	Parameters are the ones of FF_LED::setBlink()
+
+	\param[in]	_priority: effect priority (higher wins)
+	\return	true if effect set, false if table is full
+
+*/
+bool FF_LEDStack::setBlink(uint8_t _priority, uint8_t _blinkCount, unsigned long _onTime, unsigned long _offTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel, uint8_t _cycleCount, ledLevelType _finalLevel) {
+    ledSlotType *slot = prepare(_priority);
+    if (!slot) {
+        return false;
+    }
+    if (isTop(slot)) {
+        stackLed->setBlink(_blinkCount, _onTime, _offTime, _waitTime, _minLevel, _maxLevel, _cycleCount, _finalLevel);
+    } else {
+        FF_LED_ENTER_CRITICAL();
+        slot->setBlink(_blinkCount, _onTime, _offTime, _waitTime, _minLevel, _maxLevel);
+        slot->slotCyclesLeft = _cycleCount;
+        slot->slotFinalLevel = _finalLevel;
+        slot->slotPausedAt = slot->ledLastTimeChanged;
+        FF_LED_EXIT_CRITICAL();
+    }
+    return true;
+}
+
+/*!
+
+	\brief	Set a continous pulse at a given priority
+
+	Parameters are the ones of FF_LED::setPulse()
+
+	\param[in]	_priority: effect priority (higher wins)
+	\return	true if effect set, false if table is full
+
+*/
+bool FF_LEDStack::setPulse(uint8_t _priority, bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel, uint8_t _cycleCount, ledLevelType _finalLevel) {
+    ledSlotType *slot = prepare(_priority);
+    if (!slot) {
+        return false;
+    }
+    if (isTop(slot)) {
+        stackLed->setPulse(_increase, _upTime, _downTime, _waitTime, _minLevel, _maxLevel, _cycleCount, _finalLevel);
+    } else {
+        FF_LED_ENTER_CRITICAL();
+        slot->setPulse(_increase, _upTime, _downTime, _waitTime, _minLevel, _maxLevel);
+        slot->slotCyclesLeft = _cycleCount;
+        slot->slotFinalLevel = _finalLevel;
+        slot->slotPausedAt = slot->ledLastTimeChanged;
+        FF_LED_EXIT_CRITICAL();
+    }
+    return true;
+}
+
+/*!
+
+	\brief	Set a continous time based pulse at a given priority
+
+	Parameters are the ones of FF_LED::setTimedPulse()
+
+	\param[in]	_priority: effect priority (higher wins)
+	\return	true if effect set, false if table is full
+
+*/
+bool FF_LEDStack::setTimedPulse(uint8_t _priority, bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel, uint8_t _cycleCount, ledLevelType _finalLevel) {
+    ledSlotType *slot = prepare(_priority);
+    if (!slot) {
+        return false;
+    }
+    if (isTop(slot)) {
+        stackLed->setTimedPulse(_increase, _upTime, _downTime, _waitTime, _minLevel, _maxLevel, _cycleCount, _finalLevel);
+    } else {
+        FF_LED_ENTER_CRITICAL();
+        slot->setTimedPulse(_increase, _upTime, _downTime, _waitTime, _minLevel, _maxLevel);
+        slot->slotCyclesLeft = _cycleCount;
+        slot->slotFinalLevel = _finalLevel;
+        slot->slotPausedAt = slot->ledLastTimeChanged;
+        FF_LED_EXIT_CRITICAL();
+    }
+    return true;
+}
+
+/*!
+
+	\brief	Play a sequence of steps at a given priority
+
+	Parameters are the ones of FF_LED::setSequence(). First ramp of a sequence set below top effect
+	starts from level of previous effect of this priority.
+
+	\param[in]	_priority: effect priority (higher wins)
+	\return	true if effect set, false if table is full
+
+*/
+bool FF_LEDStack::setSequence(uint8_t _priority, const ledStepType *_steps, uint8_t _stepCount, bool _repeat) {
+    ledSlotType *slot = prepare(_priority);
+    if (!slot) {
+        return false;
+    }
+    if (isTop(slot)) {
+        stackLed->setSequence(_steps, _stepCount, _repeat);
+    } else {
+        FF_LED_ENTER_CRITICAL();
+        slot->setSequence(_steps, _stepCount, _repeat);
+        slot->slotCyclesLeft = 0;
+        slot->slotPausedAt = slot->ledLastTimeChanged;
+        FF_LED_EXIT_CRITICAL();
+    }
+    return true;
+}
+
+/*!
+
+	\brief	Release effect of a given priority
+
+	Remove effect from table. If it was on top, effect below resumes (or LED is set to idle level if none left).
+
+	\param[in]	_priority: priority of effect to remove
+	\return	none
+
+*/
+void FF_LEDStack::release(uint8_t _priority) {
+    FF_LED_ENTER_CRITICAL();
+    uint8_t index = 0;
+    while (index < stackCount && stackSlots[index].slotPriority != _priority) {
+        index++;
+    }
+    if (index >= stackCount) {                  // Priority not used
+        FF_LED_EXIT_CRITICAL();
+        return;
+    }
+    bool wasTop = (index == stackCount - 1);
+    for (; index < stackCount - 1; index++) {   // Keep table sorted
+        stackSlots[index] = stackSlots[index + 1];
+    }
+    stackCount--;
+    if (wasTop && stackCount) {
+        restore(&stackSlots[stackCount - 1], FF_LED::toTicks(millis()));
+    }
+    FF_LED_EXIT_CRITICAL();
+    if (wasTop && !stackCount) {
+        stackLed->setFixed(stackIdleLevel);
+    }
+}
+
+/*!
+
+	\brief	Is an effect set at a given priority?
+
+	\param[in]	_priority: priority to check
+	\return	true if an effect of this priority is in table
+
+*/
+bool FF_LEDStack::isActive(uint8_t _priority) {
+    for (uint8_t i = 0; i < stackCount; i++) {
+        if (stackSlots[i].slotPriority == _priority) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*!
+
+	\brief	Return count of effects in table
+
+	\return	count of effects (running one and paused ones)
+
+*/
+uint8_t FF_LEDStack::count(void) {
+    return stackCount;
+}
+
+/*!
+
+	\brief	Find or insert slot of a priority
+
+	Return slot of given priority, inserting it at its place if needed. When the new slot becomes
+	top, effect running on LED is paused in previous top slot.
+
+	\param[in]	_priority: effect priority
+	\return	slot of priority, nullptr if table is full
+
+*/
+FF_LEDStack::ledSlotType *FF_LEDStack::prepare(uint8_t _priority) {
+    FF_LED_ENTER_CRITICAL();
+    uint8_t index = 0;
+    while (index < stackCount && stackSlots[index].slotPriority < _priority) {
+        index++;
+    }
+    if (index < stackCount && stackSlots[index].slotPriority == _priority) {
+        FF_LED_EXIT_CRITICAL();
+        return &stackSlots[index];              // Priority already used
+    }
+    if (stackCount >= stackMaxSlots) {
+        FF_LED_EXIT_CRITICAL();
+        return nullptr;
+    }
+    if (index == stackCount && stackCount) {    // New top, pause running effect
+        save(&stackSlots[stackCount - 1], FF_LED::toTicks(millis()));
+    }
+    for (uint8_t i = stackCount; i > index; i--) {
+        stackSlots[i] = stackSlots[i - 1];
+    }
+    ledSlotType *slot = &stackSlots[index];
+    (FF_LEDCore &) *slot = (FF_LEDCore &) *stackLed; // Start from LED state (first ramp of a sequence starts from its level)
+    slot->slotPriority = _priority;
+    slot->slotCyclesLeft = 0;
+    stackCount++;
+    FF_LED_EXIT_CRITICAL();
+    return slot;
+}
+
+/*!
+
+	\brief	Is slot the top one?
+
+	\param[in]	_slot: slot to check
+	\return	true if slot's effect runs on LED
+
+*/
+bool FF_LEDStack::isTop(ledSlotType *_slot) {
+    return _slot == &stackSlots[stackCount - 1];
+}
+
+/*!
+
+	\brief	Pause effect running on LED
+
+	Copy LED state machine to slot (ending running transition first)
+
+	\param[in]	_slot: slot to save effect into
+	\param[in]	_now: current time (in ticks, as returned by toTicks())
+	\return	none
+
+*/
+void FF_LEDStack::save(ledSlotType *_slot, FF_LEDCore::ledTimeType _now) {
+    #ifdef FF_LED_TRANSITIONS
+        if (stackLed->ledTransiting) {
+            stackLed->endTransition();
+        }
+    #endif
+    (FF_LEDCore &) *_slot = (FF_LEDCore &) *stackLed;
+    _slot->slotCyclesLeft = stackLed->ledCyclesLeft;
+    _slot->slotFinalLevel = stackLed->ledFinalLevel;
+    _slot->slotPausedAt = _now;
+}
+
+/*!
+
+	\brief	Resume a paused effect
+
+	Copy slot to LED state machine, shifting its times by pause duration, then write LED
+
+	\param[in]	_slot: slot to restore effect from
+	\param[in]	_now: current time (in ticks, as returned by toTicks())
+	\return	none
+
+*/
+void FF_LEDStack::restore(ledSlotType *_slot, FF_LEDCore::ledTimeType _now) {
+    FF_LEDCore::ledTimeType pause = _now - _slot->slotPausedAt;
+    (FF_LEDCore &) *stackLed = (FF_LEDCore &) *_slot;
+    stackLed->ledLastTimeChanged += pause;
+    if (stackLed->ledMode == FF_LEDCore::timedPulse) {
+        stackLed->ledCycleStart += pause;
+    } else if (stackLed->ledMode == FF_LEDCore::sequence) {
+        stackLed->ledStepStart += pause;
+    }
+    stackLed->ledCyclesLeft = _slot->slotCyclesLeft;
+    stackLed->ledFinalLevel = _slot->slotFinalLevel;
+    #ifdef FF_LED_TRANSITIONS
+        stackLed->ledTransiting = false;
+    #endif
+    stackLed->writeLed();
+    stackLed->groupChanged();
+}
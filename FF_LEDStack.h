@@ -0,0 +1,59 @@
+/*!
+	\file
+	\brief	Priority layered effects on one FF_LED
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Have a look at FF_LEDStack.cpp for details
+
+*/
+
+
+#ifndef FF_LEDStack_h
+    #define FF_LEDStack_h
+    #include "FF_LED.h"
+
+    #ifdef __cplusplus
+        class FF_LEDStack {
+            /*!	\class FF_LEDStack
+                \brief Several effects with priorities on one LED, only highest priority one running
+            */
+            public:
+                typedef FF_LEDCore::ledLevelType ledLevelType;  //!< LED level definition
+                typedef FF_LEDCore::ledStepType ledStepType;    //!< Sequence step definition
+                class ledSlotType : public FF_LEDCore {
+                    /*!	\class ledSlotType
+                        \brief Effect of one priority (paused state machine when not on top)
+                    */
+                    public:
+                        ledSlotType(void) : FF_LEDCore(0) {}
+                    private:
+                        friend class FF_LEDStack;
+                        ledTimeType slotPausedAt = 0;           //!< Time effect was paused (or set)
+                        ledLevelType slotFinalLevel = 0;        //!< Level kept after last cycle
+                        uint8_t slotCyclesLeft = 0;             //!< Cycles to run before settling to final level (0 for ever)
+                        uint8_t slotPriority = 0;               //!< Priority of effect (higher wins)
+                };
+                FF_LEDStack(FF_LED *_led, ledSlotType *_slots, uint8_t _maxSlots, ledLevelType _idleLevel = 0);
+                bool setFixed(uint8_t _priority, ledLevelType _level);
+                bool setBlink(uint8_t _priority, uint8_t _blinkCount, unsigned long _onTime, unsigned long _offTime, unsigned long _waitTime, ledLevelType _minLevel = 0, ledLevelType _maxLevel = FF_LED_MAX_LEVEL, uint8_t _cycleCount = 0, ledLevelType _finalLevel = 0);
+                bool setPulse(uint8_t _priority, bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel = 0, ledLevelType _maxLevel = FF_LED_MAX_LEVEL, uint8_t _cycleCount = 0, ledLevelType _finalLevel = 0);
+                bool setTimedPulse(uint8_t _priority, bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel = 0, ledLevelType _maxLevel = FF_LED_MAX_LEVEL, uint8_t _cycleCount = 0, ledLevelType _finalLevel = 0);
+                bool setSequence(uint8_t _priority, const ledStepType *_steps, uint8_t _stepCount, bool _repeat = true);
+                void release(uint8_t _priority);
+                bool isActive(uint8_t _priority);
+                uint8_t count(void);
+            private:
+                ledSlotType *prepare(uint8_t _priority);
+                bool isTop(ledSlotType *_slot);
+                void save(ledSlotType *_slot, FF_LEDCore::ledTimeType _now);
+                void restore(ledSlotType *_slot, FF_LEDCore::ledTimeType _now);
+
+                FF_LED *stackLed = nullptr;                     //!< LED running top effect
+                ledSlotType *stackSlots = nullptr;              //!< Effect table, sorted by increasing priority (given by caller)
+                uint8_t stackMaxSlots = 0;                      //!< Size of effect table
+                uint8_t stackCount = 0;                         //!< Count of effects in table
+                ledLevelType stackIdleLevel = 0;                //!< LED level when no effect is left
+        };
+    #endif
+#endif
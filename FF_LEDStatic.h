@@ -0,0 +1,162 @@
+/*!
+	\file
+	\brief	Classes owning their tables, sized at compile time, and RAM report of LED objects
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Library never allocates memory: each class using a table (group LEDs, stack slots, service queue,
+	driver buffers...) gets it from caller. Classes of this file declare these tables themselves,
+	with a size given as template parameter, so that a single global declaration is needed and
+	table size can't be wrong:
+
+		FF_LEDGroupT<24> myGroup;               // Same as FF_LED *myLeds[24]; FF_LEDGroup myGroup(myLeds, 24);
+		FF_LEDStackT<3> statusStack(&statusLed);
+		FF_LED74HC595T<2> shiftChain(10);
+		FF_LEDServiceT<16> myService(&myGroup); // ESP32 only, size checked to be a power of 2
+
+	Objects being global (or static), all RAM used is known at link time. FF_LEDRamSize() computes
+	total size of given objects at compile time, FF_LED_RAM_CHECK() stops compilation if it exceeds
+	a budget:
+
+		FF_LED_RAM_CHECK(1024, myGroup, statusStack, statusLed, wifiLed);
+		Serial.printf("LEDs use %u bytes\n", (unsigned) FF_LEDRamSize(myGroup, statusStack, statusLed, wifiLed));
+
+*/
+
+
+#ifndef FF_LEDStatic_h
+    #define FF_LEDStatic_h
+    #include "FF_LED.h"
+    #include "FF_LEDGroup.h"
+    #include "FF_LEDSync.h"
+    #include "FF_LEDStack.h"
+    #include "FF_LEDService.h"
+    #include "FF_LED74HC595.h"
+    #include "FF_LEDStrip.h"
+    #include "FF_LEDAPA102.h"
+
+    #ifdef __cplusplus
+        template <typename itemType, uint16_t itemCount>
+        struct FF_LEDPool {
+            /*!	\struct FF_LEDPool
+                \brief Table of itemCount items, constructed before class using it (first base class)
+            */
+            itemType poolItems[itemCount];                      //!< Pool items
+        };
+
+        template <uint8_t maxLeds>
+        class FF_LEDGroupT : private FF_LEDPool<FF_LED *, maxLeds>, public FF_LEDGroup {
+            /*!	\class FF_LEDGroupT
+                \brief FF_LEDGroup with its table of maxLeds LEDs
+            */
+            static_assert(maxLeds > 0, "FF_LEDGroupT needs at least one LED");
+            public:
+                FF_LEDGroupT(void) : FF_LEDGroup(this->poolItems, maxLeds) {}
+        };
+
+        template <uint8_t maxLeds>
+        class FF_LEDSyncT : private FF_LEDPool<FF_LED *, maxLeds>, public FF_LEDSync {
+            /*!	\class FF_LEDSyncT
+                \brief FF_LEDSync with its table of maxLeds LEDs
+            */
+            static_assert(maxLeds > 0, "FF_LEDSyncT needs at least one LED");
+            public:
+                /*!
+                    \brief	Class constructor
+                    \param[in]	_initialLevel: LEDs level (0-FF_LED_MAX_LEVEL) at startup (default = 0)
+                */
+                FF_LEDSyncT(ledLevelType _initialLevel = 0) : FF_LEDSync(this->poolItems, maxLeds, _initialLevel) {}
+        };
+
+        template <uint8_t maxSlots>
+        class FF_LEDStackT : private FF_LEDPool<FF_LEDStack::ledSlotType, maxSlots>, public FF_LEDStack {
+            /*!	\class FF_LEDStackT
+                \brief FF_LEDStack with its table of maxSlots effect slots
+            */
+            static_assert(maxSlots > 0, "FF_LEDStackT needs at least one slot");
+            public:
+                /*!
+                    \brief	Class constructor
+                    \param[in]	_led: LED running effects
+                    \param[in]	_idleLevel: LED level set when last effect is released (default to 0)
+                */
+                FF_LEDStackT(FF_LED *_led, ledLevelType _idleLevel = 0) : FF_LEDStack(_led, this->poolItems, maxSlots, _idleLevel) {}
+        };
+
+        #ifdef FF_LED_HAS_SERVICE
+            template <uint16_t maxCommands>
+            class FF_LEDServiceT : private FF_LEDPool<FF_LEDService::ledCommandType, maxCommands>, public FF_LEDService {
+                /*!	\class FF_LEDServiceT
+                    \brief FF_LEDService with its ring of maxCommands command slots
+                */
+                static_assert(maxCommands > 0 && !(maxCommands & (maxCommands - 1)), "FF_LEDServiceT queue size should be a power of 2");
+                public:
+                    /*!
+                        \brief	Class constructor
+                        \param[in]	_group: group of LEDs to be run by service task
+                    */
+                    FF_LEDServiceT(FF_LEDGroup *_group) : FF_LEDService(_group, this->poolItems, maxCommands) {}
+            };
+        #endif
+
+        template <uint8_t chipCount>
+        class FF_LED74HC595T : private FF_LEDPool<uint8_t, chipCount>, public FF_LED74HC595 {
+            /*!	\class FF_LED74HC595T
+                \brief FF_LED74HC595 with its bit buffer for chipCount chips
+            */
+            static_assert(chipCount > 0, "FF_LED74HC595T needs at least one chip");
+            public:
+                /*!
+                    \brief	Class constructor
+                    \param[in]	_latchPin: pin connected to latch (RCLK)
+                    \param[in]	_spiClock: SPI clock (in Hz, default to 4 MHz)
+                */
+                FF_LED74HC595T(uint8_t _latchPin, uint32_t _spiClock = 4000000) : FF_LED74HC595(_latchPin, this->poolItems, chipCount, _spiClock) {}
+        };
+
+        template <uint8_t pixelCount>
+        class FF_LEDStripT : private FF_LEDPool<FF_LEDStrip::pixelType, pixelCount>, private FF_LEDPool<uint8_t, 3 * pixelCount>, public FF_LEDStrip {
+            /*!	\class FF_LEDStripT
+                \brief FF_LEDStrip with its pixels table and frame buffer for pixelCount pixels
+            */
+            static_assert(pixelCount > 0, "FF_LEDStripT needs at least one pixel");
+            public:
+                /*!
+                    \brief	Class constructor
+                    \param[in]	_push: function sending frame buffer to strip
+                    \param[in]	_order: order of colors expected by strip (default to grb)
+                */
+                FF_LEDStripT(pushType _push = nullptr, colorOrderType _order = grb) :
+                    FF_LEDStrip(FF_LEDPool<pixelType, pixelCount>::poolItems, FF_LEDPool<uint8_t, 3 * pixelCount>::poolItems, pixelCount, _push, _order) {}
+        };
+
+        template <uint8_t pixelCount>
+        class FF_LEDAPA102T : private FF_LEDPool<FF_LEDStrip::pixelType, pixelCount>, private FF_LEDPool<uint8_t, 3 * pixelCount>, public FF_LEDAPA102 {
+            /*!	\class FF_LEDAPA102T
+                \brief FF_LEDAPA102 with its pixels table and frame buffer for pixelCount pixels
+            */
+            static_assert(pixelCount > 0, "FF_LEDAPA102T needs at least one pixel");
+            public:
+                /*!
+                    \brief	Class constructor
+                    \param[in]	_spiClock: SPI clock (in Hz, default to 4 MHz)
+                */
+                FF_LEDAPA102T(uint32_t _spiClock = 4000000) :
+                    FF_LEDAPA102(FF_LEDPool<pixelType, pixelCount>::poolItems, FF_LEDPool<uint8_t, 3 * pixelCount>::poolItems, pixelCount, _spiClock) {}
+        };
+
+        /*! \brief Size of one object (in bytes, including tables it owns) */
+        template <typename objectType>
+        constexpr size_t FF_LEDRamSize(const objectType &) {
+            return sizeof(objectType);
+        }
+
+        /*! \brief Total size of given objects (in bytes, including tables they own) */
+        template <typename objectType, typename... otherTypes>
+        constexpr size_t FF_LEDRamSize(const objectType &, const otherTypes &... _others) {
+            return sizeof(objectType) + FF_LEDRamSize(_others...);
+        }
+
+        #define FF_LED_RAM_CHECK(_budget, ...) static_assert(FF_LEDRamSize(__VA_ARGS__) <= (_budget), "LED objects use more RAM than " #_budget " bytes") //!< Stop compilation if given objects use more than _budget bytes
+    #endif
+#endif
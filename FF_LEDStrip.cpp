@@ -0,0 +1,172 @@
+/*!
+	\file
+	\brief	Addressable LED strip (WS2812, SK6812...) output driver for FF_LED
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Each pixel of strip is a driver channel, so each FF_LED connected to strip gives fixed,
+	blink and pulse effects to one pixel, LED level scaling pixel's color.
+
+	LED levels are written in place in a contiguous frame buffer, already in strip's color order.
+	Frame is pushed once per loop of group (or on each write for LEDs not in a group), only if
+	a pixel changed, and only up to last changed pixel (next pixels keep their color).
+
+	As WS2812 timing is too tight to be generated here, frame is sent by a function given by sketch,
+	using whatever fits target (ESP32 RMT, RP2040 PIO, NeoPixel library, DMA...). See FF_LEDAPA102
+	for a strip driven by SPI.
+
+	Pixels and frame buffers are given by caller, so driver doesn't allocate any memory:
+
+		FF_LEDStrip::pixelType stripPixels[8];
+		uint8_t stripFrame[8 * 3];
+		void pushStrip(const uint8_t *_frame, uint16_t _size) {rmtWriteBytes(_frame, _size);}
+		FF_LEDStrip strip(stripPixels, stripFrame, 8, pushStrip);
+		FF_LED pixel0(&strip, 0);
+
+	As FF_LED channels are 8 bits, a strip can't have more than 255 pixels.
+*/
+
+#include "FF_LEDStrip.h"
+
+/*!
+
+	\brief	Class constructor
+
+	Initialize the class. All pixels are white, level 0.
+
+	\param[in]	_pixels: pixels table to be used by driver (_pixelCount items)
+	\param[in]	_frame: frame buffer to be used by driver (3 * _pixelCount bytes)
+	\param[in]	_pixelCount: count of pixels in strip
+	\param[in]	_push: function sending frame buffer to strip (may be nullptr if send() is overloaded)
+	\param[in]	_order: order of colors expected by strip (default to grb, as WS2812)
+	\return	none
+
+*/
+FF_LEDStrip::FF_LEDStrip(pixelType *_pixels, uint8_t *_frame, uint8_t _pixelCount, pushType _push, colorOrderType _order) {
+    stripPixels = _pixels;
+    stripFrame = _frame;
+    stripPixelCount = _pixelCount;
+    stripPush = _push;
+    stripOrder = _order;
+    for (uint8_t i = 0; i < stripPixelCount; i++) {
+        memset(stripPixels[i].color, 255, sizeof(stripPixels[i].color));
+        stripPixels[i].level = 0;
+    }
+    memset(stripFrame, 0, 3 * stripPixelCount);
+}
+
+/*!
+
+	\brief	Start driver
+
+	Push whole frame. Should be called in setup(), after starting strip hardware.
+
+	\return	none
+
+*/
+void FF_LEDStrip::begin(void) {
+    stripDirtyCount = stripPixelCount;          // Force initial state
+    outputDirty = true;
+    flush();
+}
+
+/*!
+
+	\brief	Stage a pixel level
+
+	\param[in]	_channel: pixel number (0 to _pixelCount - 1)
+	\param[in]	_value: value to write (0-FF_LED_MAX_LEVEL, already inverted if needed)
+	\return	none
+
+*/
+void FF_LEDStrip::write(uint8_t _channel, FF_LEDCore::ledLevelType _value) {
+    if (_channel >= stripPixelCount || stripPixels[_channel].level == _value) {
+        return;
+    }
+    stripPixels[_channel].level = _value;
+    computePixel(_channel);
+}
+
+/*!
+
+	\brief	Set pixel color
+
+	Set color of pixel at full level. Frame buffer is updated with current level.
+
+	\param[in]	_pixel: pixel number (0 to _pixelCount - 1)
+	\param[in]	_red: red component (0-255)
+	\param[in]	_green: green component (0-255)
+	\param[in]	_blue: blue component (0-255)
+	\return	none
+
+*/
+void FF_LEDStrip::setColor(uint8_t _pixel, uint8_t _red, uint8_t _green, uint8_t _blue) {
+    if (_pixel >= stripPixelCount) {
+        return;
+    }
+    uint8_t *color = stripPixels[_pixel].color;
+    if (stripOrder == rgb) {
+        color[0] = _red; color[1] = _green; color[2] = _blue;
+    } else if (stripOrder == grb) {
+        color[0] = _green; color[1] = _red; color[2] = _blue;
+    } else {
+        color[0] = _blue; color[1] = _green; color[2] = _red;
+    }
+    computePixel(_pixel);
+}
+
+/*!
+
+	\brief	Get frame buffer
+
+	\return	frame buffer (3 bytes per pixel, in strip's color order)
+
+*/
+const uint8_t *FF_LEDStrip::getFrame(void) {
+    return stripFrame;
+}
+
+/*!
+
+	\brief	Compute pixel in frame buffer
+
+	Scale pixel color by its level, marking frame dirty if it changed
+
+	\param[in]	_pixel: pixel number
+	\return	none
+
+*/
+void FF_LEDStrip::computePixel(uint8_t _pixel) {
+    uint8_t *frame = &stripFrame[3 * _pixel];
+    pixelType *pixel = &stripPixels[_pixel];
+    bool changed = false;
+    for (uint8_t i = 0; i < 3; i++) {
+        uint8_t value = ((uint32_t) pixel->color[i] * pixel->level + (FF_LED_MAX_LEVEL / 2)) / FF_LED_MAX_LEVEL;
+        if (frame[i] != value) {
+            frame[i] = value;
+            changed = true;
+        }
+    }
+    if (changed) {
+        if (_pixel >= stripDirtyCount) {
+            stripDirtyCount = _pixel + 1;       // Push up to this pixel
+        }
+        outputDirty = true;
+    }
+}
+
+/*!
+
+	\brief	Send staged values
+
+	Push frame buffer up to last changed pixel
+
+	\return	none
+
+*/
+void FF_LEDStrip::send(void) {
+    if (stripPush) {
+        stripPush(stripFrame, 3 * stripDirtyCount);
+    }
+    stripDirtyCount = 0;
+}
@@ -0,0 +1,46 @@
+/*!
+	\file
+	\brief	Addressable LED strip (WS2812, SK6812...) output driver for FF_LED
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Have a look at FF_LEDStrip.cpp for details
+
+*/
+
+
+#ifndef FF_LEDStrip_h
+    #define FF_LEDStrip_h
+    #include "FF_LEDOutput.h"
+
+    #ifdef __cplusplus
+        class FF_LEDStrip : public FF_LEDOutput {
+            /*!	\class FF_LEDStrip
+                \brief Addressable LED strip, each pixel being a channel, frame pushed once when changed
+            */
+            public:
+                enum colorOrderType {rgb, grb, bgr};            //!< Order of colors in frame buffer (as expected by strip)
+                struct pixelType {
+                    uint8_t color[3];                           //!< Pixel color at full level (in frame buffer order)
+                    FF_LEDCore::ledLevelType level;             //!< Last level written by FF_LED
+                };
+                typedef void (*pushType)(const uint8_t *_frame, uint16_t _size); //!< Function sending frame buffer to strip
+
+                FF_LEDStrip(pixelType *_pixels, uint8_t *_frame, uint8_t _pixelCount, pushType _push = nullptr, colorOrderType _order = grb);
+                void begin(void) override;
+                void write(uint8_t _channel, FF_LEDCore::ledLevelType _value) override;
+                void setColor(uint8_t _pixel, uint8_t _red, uint8_t _green, uint8_t _blue);
+                const uint8_t *getFrame(void);
+            protected:
+                void send(void) override;
+                void computePixel(uint8_t _pixel);
+
+                pixelType *stripPixels = nullptr;               //!< Pixels colors and levels (given by caller)
+                uint8_t *stripFrame = nullptr;                  //!< Frame buffer (given by caller, 3 bytes per pixel)
+                uint8_t stripPixelCount = 0;                    //!< Count of pixels in strip
+                uint8_t stripDirtyCount = 0;                    //!< Count of pixels to push (up to last changed one)
+                pushType stripPush = nullptr;                   //!< Function sending frame buffer to strip
+                colorOrderType stripOrder = grb;                //!< Order of colors in frame buffer
+        };
+    #endif
+#endif
@@ -0,0 +1,239 @@
+/*!
+	\file
+	\brief	Drive several FF_LED from one shared state machine
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	LEDs showing the same effect (an alarm blinking on 10 LEDs...) are added to a sync group,
+	and effect is set on the group instead of each LED. Group keeps one timing state, so state
+	machine runs once per change for all LEDs, and all LEDs switch together, without drift.
+
+	Group writes its level to each LED as a fixed level, so LEDs may stay in a FF_LEDGroup
+	(they never change by themselves). Each LED keeps its own pin, inversion or output driver.
+	Drivers are flushed once per change of group.
+
+	LED table is given by caller, so group doesn't allocate any memory:
+
+		FF_LED *alarmLeds[10];
+		FF_LEDSync alarm(alarmLeds, 10);
+		alarm.add(&led1);
+		alarm.add(&led2);
+		alarm.setBlink(3, 100, 100, 1000);
+*/
+
+#include "FF_LEDSync.h"
+#include "FF_LEDOutput.h"
+
+/*!
+
+	\brief	Class constructor
+
+	Initialize the class
+
+	\param[in]	_leds: table of FF_LED pointers to be used by group
+	\param[in]	_maxLeds: size of _leds table
+	\param[in]	_initialLevel: LED level (0-FF_LED_MAX_LEVEL) at startup (default = 0)
+	\return	none
+
+*/
+FF_LEDSync::FF_LEDSync(FF_LED **_leds, uint8_t _maxLeds, ledLevelType _initialLevel) : FF_LEDCore(_initialLevel) {
+    syncLeds = _leds;
+    syncMaxLeds = _maxLeds;
+    syncLedCount = 0;
+}
+
+/*!
+
+	\brief	Add a LED to sync group
+
+	Add a LED to sync group. LED's own effect is replaced by group's one.
+
+	\param[in]	_led: LED to add
+	\return	true if LED added, false if table is full or LED already in group
+
+*/
+bool FF_LEDSync::add(FF_LED *_led) {
+    bool added = false;
+    FF_LED_ENTER_CRITICAL();                    // Protect table against timer driven loop
+    bool found = false;
+    for (uint8_t i = 0; i < syncLedCount; i++) {
+        if (syncLeds[i] == _led) {              // Already in group, would be stepped twice
+            found = true;
+            break;
+        }
+    }
+    if (!found && syncLedCount < syncMaxLeds) {
+        syncLeds[syncLedCount++] = _led;
+        _led->FF_LEDCore::setFixed(ledLevel);   // Follow group level
+        _led->writeLed();
+        _led->groupChanged();
+        added = true;
+    }
+    FF_LED_EXIT_CRITICAL();
+    return added;
+}
+
+/*!
+
+	\brief	Return count of LEDs in sync group
+
+	\return	count of LEDs in sync group
+
+*/
+uint8_t FF_LEDSync::count(void) {
+    return syncLedCount;
+}
+
+/*!
+
+	\brief	Start class
+
+	Start all LEDs in group at group level. Should be called in setup(), after adding LEDs.
+
+	\return	none
+
+*/
+void FF_LEDSync::begin(void) {
+    setLed(ledLevel, ledForEver);
+    for (uint8_t i = 0; i < syncLedCount; i++) {
+        syncLeds[i]->begin();
+    }
+    writeLeds();
+}
+
+/*!
+
+	\brief	Loop
+
+	Loop part of class. Should be called in loop().
+
+	\return	time before next change (in ms), FF_LED_WAIT_FOR_EVER if LEDs never change
+
+*/
+unsigned long FF_LED_IRAM_ATTR FF_LEDSync::loop(void) {
+    #ifdef FF_LED_BRIGHTNESS
+        if (syncBrightnessSerial != ledBrightnessSerial) {
+            syncBrightnessSerial = ledBrightnessSerial;
+            writeLeds();                        // Write new output of all LEDs
+        }
+    #endif
+    if (isIdle()) {
+        return FF_LED_WAIT_FOR_EVER;            // Nothing to do until a new effect is set
+    }
+    unsigned long now = millis();
+    if (FF_LEDCore::loop(now)) {               // State machine runs once for all LEDs
+        writeLeds();
+    }
+    return FF_LEDCore::nextChangeIn(now);
+}
+
+/*!
+
+	\brief	Time until next change
+
+	\return	time before next change (in ms), 0 if change is due, FF_LED_WAIT_FOR_EVER if LEDs never change
+
+*/
+unsigned long FF_LEDSync::nextChangeIn(void) {
+    if (isIdle()) {
+        return FF_LED_WAIT_FOR_EVER;
+    }
+    return FF_LEDCore::nextChangeIn(millis());
+}
+
+/*!
+
+	\brief	Write group level to all LEDs
+
+	Set group level as fixed level of each LED, then flush output drivers once
+
+	\return	none
+
+*/
+void FF_LED_IRAM_ATTR FF_LEDSync::writeLeds(void) {
+    for (uint8_t i = 0; i < syncLedCount; i++) {
+        FF_LED *led = syncLeds[i];
+        led->FF_LEDCore::setLed(ledLevel, ledForEver, ledLastTimeChanged);
+        led->ledMode = fixed;
+        #ifdef FF_LED_TRANSITIONS
+            led->ledTransiting = false;
+        #endif
+        led->writeLed();
+    }
+    for (uint8_t i = 0; i < syncLedCount; i++) {
+        FF_LEDOutput *driver = syncLeds[i]->ledDriver;
+        if (driver) {
+            driver->flush();                    // One transaction per driver (does nothing if already sent)
+        }
+    }
+}
+
+/*!
+
+	\brief	Set LEDs to fixed level (see FF_LEDCore::setFixed())
+
+	\return	none
+
+*/
+void FF_LEDSync::setFixed(ledLevelType _level) {
+    FF_LED_ENTER_CRITICAL();                    // Protect state against timer driven loop
+    FF_LEDCore::setFixed(_level);
+    writeLeds();
+    FF_LED_EXIT_CRITICAL();
+}
+
+/*!
+
+	\brief	Start LEDs blinking sequence (see FF_LEDCore::setBlink())
+
+	\return	none
+
+*/
+void FF_LEDSync::setBlink(uint8_t _blinkCount, unsigned long _onTime, unsigned long _offTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel) {
+    FF_LED_ENTER_CRITICAL();
+    FF_LEDCore::setBlink(_blinkCount, _onTime, _offTime, _waitTime, _minLevel, _maxLevel);
+    writeLeds();
+    FF_LED_EXIT_CRITICAL();
+}
+
+/*!
+
+	\brief	Start LEDs pulse sequence (see FF_LEDCore::setPulse())
+
+	\return	none
+
+*/
+void FF_LEDSync::setPulse(bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel) {
+    FF_LED_ENTER_CRITICAL();
+    FF_LEDCore::setPulse(_increase, _upTime, _downTime, _waitTime, _minLevel, _maxLevel);
+    writeLeds();
+    FF_LED_EXIT_CRITICAL();
+}
+
+/*!
+
+	\brief	Start LEDs time based pulse sequence (see FF_LEDCore::setTimedPulse())
+
+	\return	none
+
+*/
+void FF_LEDSync::setTimedPulse(bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel, ledLevelType _maxLevel) {
+    FF_LED_ENTER_CRITICAL();
+    FF_LEDCore::setTimedPulse(_increase, _upTime, _downTime, _waitTime, _minLevel, _maxLevel);
+    writeLeds();
+    FF_LED_EXIT_CRITICAL();
+}
+
+/*!
+
+	\brief	Play a sequence of steps on LEDs (see FF_LEDCore::setSequence())
+
+	\return	none
+
+*/
+void FF_LEDSync::setSequence(const ledStepType *_steps, uint8_t _stepCount, bool _repeat) {
+    FF_LED_ENTER_CRITICAL();
+    FF_LEDCore::setSequence(_steps, _stepCount, _repeat);
+    writeLeds();
+    FF_LED_EXIT_CRITICAL();
+}
@@ -0,0 +1,44 @@
+/*!
+	\file
+	\brief	Drive several FF_LED from one shared state machine
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Have a look at FF_LEDSync.cpp for details
+
+*/
+
+
+#ifndef FF_LEDSync_h
+    #define FF_LEDSync_h
+    #include "FF_LED.h"
+
+    #ifdef __cplusplus
+        class FF_LEDSync : public FF_LEDCore {
+            /*!	\class FF_LEDSync
+                \brief Several FF_LED sharing one state machine, switching together
+            */
+            public:
+                FF_LEDSync(FF_LED **_leds, uint8_t _maxLeds, ledLevelType _initialLevel = 0);
+                bool add(FF_LED *_led);
+                uint8_t count(void);
+                void begin(void);
+                unsigned long loop(void);
+                unsigned long nextChangeIn(void);
+                void setFixed(ledLevelType _level);
+                void setBlink(uint8_t _blinkCount, unsigned long _onTime, unsigned long _offTime, unsigned long _waitTime, ledLevelType _minLevel = 0, ledLevelType _maxLevel = FF_LED_MAX_LEVEL);
+                void setPulse(bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel = 0, ledLevelType _maxLevel = FF_LED_MAX_LEVEL);
+                void setTimedPulse(bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel = 0, ledLevelType _maxLevel = FF_LED_MAX_LEVEL);
+                void setSequence(const ledStepType *_steps, uint8_t _stepCount, bool _repeat = true);
+            private:
+                void writeLeds(void);
+
+                FF_LED **syncLeds = nullptr;                    //!< LED table (given by caller)
+                uint8_t syncMaxLeds = 0;                        //!< Size of LED table
+                uint8_t syncLedCount = 0;                       //!< Count of LEDs in sync group
+                #ifdef FF_LED_BRIGHTNESS
+                    uint8_t syncBrightnessSerial = 0;           //!< Global brightness serial at last write
+                #endif
+        };
+    #endif
+#endif
@@ -0,0 +1,180 @@
+/*!
+	\file
+	\brief	Implement few LED effects (fixed, blinking, pulsing) with pin and inversion known at compile time
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	FF_LEDT<pin, inverted> offers the same effects as FF_LED, sharing its state machine (FF_LEDCore),
+	but pin and inversion are template parameters:
+		- inversion test disappears at compile time,
+		- on AVR, pins without PWM are written directly through port registers (port and bit mask
+		  are read from core's pin tables once, in begin(), and kept once per pin, not per instance),
+		- each instance doesn't store pin, inversion nor last written value.
+
+	Only the small pin write function is generated for each pin, state machine code is shared.
+	Hardware fade and groups are not available with this class.
+
+		FF_LEDT<13> statusLed;
+		FF_LEDT<5, true> errorLed;
+
+*/
+
+
+#ifndef FF_LEDT_h
+    #define FF_LEDT_h
+    #include "FF_LED.h"
+
+    #ifdef __cplusplus
+        template <uint8_t ledPin, bool ledInverted = false>
+        class FF_LEDT : public FF_LEDCore {
+            /*!	\class FF_LEDT
+                \brief Implement few LED effects (fixed, blinking, pulsing) on a pin known at compile time
+            */
+            public:
+                /*!
+                    \brief	Class constructor
+                    \param[in]	_initialLevel: LED level (0-FF_LED_MAX_LEVEL) at startup (default = 0)
+                */
+                FF_LEDT(ledLevelType _initialLevel = 0) : FF_LEDCore(_initialLevel) {}
+
+                ~FF_LEDT() {
+                    pinMode(ledPin, INPUT);                     // Set pin mode to input (release it)
+                }
+
+                /*!
+                    \brief	Start class. Should be called in setup().
+                */
+                void begin(void) {
+                    #if defined(__AVR__)
+                        if (digitalPinToTimer(ledPin) == NOT_ON_TIMER) { // No PWM on this pin, port will be written directly
+                            ledPort = portOutputRegister(digitalPinToPort(ledPin));
+                            ledMask = digitalPinToBitMask(ledPin);
+                        }
+                    #endif
+                    setResolution(ledPin);                      // Set PWM resolution
+                    setLed(ledLevel, ledForEver);               // Turn LED to initial state
+                    writeLed();
+                    pinMode(ledPin, OUTPUT);                    // Set pin mode to output
+                }
+
+                /*!
+                    \brief	Loop part of class. Should be called in loop().
+                    \return	time before next LED change (in ms), FF_LED_WAIT_FOR_EVER if LED never changes
+                */
+                unsigned long loop(void) {
+                    if (isIdle()) {
+                        return FF_LED_WAIT_FOR_EVER;            // Nothing to do until a new effect is set
+                    }
+                    unsigned long now = millis();
+                    if (FF_LEDCore::loop(now)) {                // Write pin only if state changed
+                        writeLed();
+                    }
+                    return FF_LEDCore::nextChangeIn(now);
+                }
+
+                /*!
+                    \brief	Time until next change
+                    \return	time before next change (in ms), 0 if change is due, FF_LED_WAIT_FOR_EVER if LED never changes
+                */
+                unsigned long nextChangeIn(void) {
+                    if (isIdle()) {
+                        return FF_LED_WAIT_FOR_EVER;
+                    }
+                    return FF_LEDCore::nextChangeIn(millis());
+                }
+
+                /*!
+                    \brief	Set LED to fixed level (see FF_LED::setFixed())
+                */
+                void setFixed(ledLevelType _level) {
+                    FF_LED_ENTER_CRITICAL();                    // Protect state against timer driven loop
+                    FF_LEDCore::setFixed(_level);
+                    writeLed();
+                    FF_LED_EXIT_CRITICAL();
+                }
+
+                /*!
+                    \brief	Start LED blinking sequence (see FF_LED::setBlink())
+                */
+                void setBlink(uint8_t _blinkCount, unsigned long _onTime, unsigned long _offTime, unsigned long _waitTime, ledLevelType _minLevel = 0, ledLevelType _maxLevel = FF_LED_MAX_LEVEL) {
+                    FF_LED_ENTER_CRITICAL();
+                    FF_LEDCore::setBlink(_blinkCount, _onTime, _offTime, _waitTime, _minLevel, _maxLevel);
+                    writeLed();
+                    FF_LED_EXIT_CRITICAL();
+                }
+
+                /*!
+                    \brief	Start LED pulse sequence (see FF_LED::setPulse())
+                */
+                void setPulse(bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel = 0, ledLevelType _maxLevel = FF_LED_MAX_LEVEL) {
+                    FF_LED_ENTER_CRITICAL();
+                    FF_LEDCore::setPulse(_increase, _upTime, _downTime, _waitTime, _minLevel, _maxLevel);
+                    writeLed();
+                    FF_LED_EXIT_CRITICAL();
+                }
+
+                /*!
+                    \brief	Start LED time based pulse sequence (see FF_LED::setTimedPulse())
+                */
+                void setTimedPulse(bool _increase, unsigned long _upTime, unsigned long _downTime, unsigned long _waitTime, ledLevelType _minLevel = 0, ledLevelType _maxLevel = FF_LED_MAX_LEVEL) {
+                    FF_LED_ENTER_CRITICAL();
+                    FF_LEDCore::setTimedPulse(_increase, _upTime, _downTime, _waitTime, _minLevel, _maxLevel);
+                    writeLed();
+                    FF_LED_EXIT_CRITICAL();
+                }
+
+                /*!
+                    \brief	Play a sequence of steps (see FF_LED::setSequence())
+                */
+                void setSequence(const ledStepType *_steps, uint8_t _stepCount, bool _repeat = true) {
+                    FF_LED_ENTER_CRITICAL();
+                    FF_LEDCore::setSequence(_steps, _stepCount, _repeat);
+                    writeLed();
+                    FF_LED_EXIT_CRITICAL();
+                }
+
+            private:
+                /*!
+                    \brief	Write current LED level to pin
+                */
+                void writeLed(void) {
+                    ledLevelType output = outputLevel(ledLevel);    // Apply brightness curve
+                    if (ledInverted) {                          // Resolved at compile time
+                        output = FF_LED_MAX_LEVEL - output;
+                    }
+                    #if defined(__AVR__)
+                        if (ledPort) {                          // No PWM on this pin, write port directly
+                            uint8_t oldSREG = SREG;
+                            cli();
+                            if (output >= (FF_LED_MAX_LEVEL + 1) / 2) { // Same threshold as analogWrite() on such pins
+                                *ledPort |= ledMask;
+                            } else {
+                                *ledPort &= ~ledMask;
+                            }
+                            SREG = oldSREG;
+                            return;
+                        }
+                    #endif
+                    if (output == 0) {
+                        digitalWrite(ledPin, LOW);
+                    } else if (output == FF_LED_MAX_LEVEL) {
+                        digitalWrite(ledPin, HIGH);
+                    } else {
+                        analogWrite(ledPin, output);
+                    }
+                }
+
+                #if defined(__AVR__)
+                    static volatile uint8_t *ledPort;           //!< Output register of pin without PWM (nullptr for PWM pin or until begin())
+                    static uint8_t ledMask;                     //!< Bit of pin in ledPort
+                #endif
+        };
+
+        #if defined(__AVR__)
+            template <uint8_t ledPin, bool ledInverted>
+            volatile uint8_t *FF_LEDT<ledPin, ledInverted>::ledPort = nullptr;
+            template <uint8_t ledPin, bool ledInverted>
+            uint8_t FF_LEDT<ledPin, ledInverted>::ledMask = 0;
+        #endif
+    #endif
+#endif
@@ -0,0 +1,294 @@
+/*!
+	\file
+	\brief	FF_LED benchmark: loop() cost and transition timing drift
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Measures on target board:
+		- average cost of FF_LED::loop() and FF_LEDGroup::loop() with 1, 10, 100 and 500 LEDs,
+			in fixed, blink and pulse modes (counts larger than BENCH_MAX_LEDS are skipped),
+		- cost of setFixed() (state change and output write),
+		- drift between requested and measured blink on time and pulse step time, alone and with 100 LEDs
+			running in the same group.
+
+	LEDs are connected to a driver which discards values, so that only FF_LED code is measured.
+	Results are sent to Serial (115200 bauds), in µs and, when board has a cycle counter, in CPU cycles.
+
+	FF_LED changes level when elapsed time exceeds requested delay, at millis() resolution,
+	so measured times are expected to be about 1 ms longer than requested ones.
+	Groups are limited to 255 LEDs, so group loop is not measured with 500 LEDs.
+	LEDs are a static table (no heap), so BENCH_MAX_LEDS should fit in board RAM.
+
+	Measures are timed by millis()/micros() loops: on host (extras/host), run sketch with --realtime,
+	as virtual clock only moves between two loop() calls (measures would never end):
+
+		extras/host/build.sh examples/bench/bench.ino bench -O2 && ./bench --realtime
+*/
+
+#include <FF_LED.h>
+#include <FF_LEDGroup.h>
+#include <FF_LEDOutput.h>
+
+#if defined(__AVR__)
+    #define BENCH_MAX_LEDS 20                   // Keep some RAM free on small AVR
+#else
+    #define BENCH_MAX_LEDS 500
+#endif
+#define BENCH_DURATION 2000                     // Duration of each measure (in ms)
+#define BENCH_BLINK_ON 20                       // Blink on time for drift test (in ms)
+#define BENCH_BLINK_OFF 30                      // Blink off time for drift test (in ms)
+#define BENCH_PULSE_UP 2                        // Pulse step time for drift test (in ms)
+
+#if defined(ESP32) || defined(ESP8266)
+    #define BENCH_CYCLES() ESP.getCycleCount()
+#elif defined(ARDUINO_ARCH_RP2040)
+    #define BENCH_CYCLES() rp2040.getCycleCount()
+#endif
+
+// Output driver discarding values (recording change times of one channel)
+class BenchOutput : public FF_LEDOutput {
+    public:
+        void begin(void) override {}
+        void write(uint8_t _channel, FF_LEDCore::ledLevelType _value) override {
+            if (probeEnabled && _channel == probeChannel && _value != probeValue) {
+                unsigned long now = micros();
+                probeInterval = now - probeLast;
+                probeLast = now;
+                probePrevious = probeValue;
+                probeValue = _value;
+                probeCount++;
+            }
+        }
+        bool probeEnabled = false;              // Record changes of probe channel?
+        uint8_t probeChannel = 0;               // Recorded channel
+        FF_LEDCore::ledLevelType probeValue = 0; // Last value written to recorded channel
+        FF_LEDCore::ledLevelType probePrevious = 0; // Value before last change
+        unsigned long probeLast = 0;            // Last change time (in µs)
+        unsigned long probeInterval = 0;        // Time between the two last changes (in µs)
+        unsigned long probeCount = 0;           // Count of changes
+    protected:
+        void send(void) override {}
+};
+
+// LED connected to next channel of bench driver (so that a static table can be declared)
+class BenchLed : public FF_LED {
+    public:
+        BenchLed(void);
+    private:
+        static uint16_t nextChannel;            // Channel of next LED
+};
+
+static const uint16_t benchCounts[] = {1, 10, 100, 500};
+static const char *modeNames[] = {"fixed", "blink", "pulse"};
+static BenchOutput benchOutput;
+uint16_t BenchLed::nextChannel = 0;
+BenchLed::BenchLed(void) : FF_LED(&benchOutput, nextChannel++ & 0xFF) {}
+static BenchLed benchLeds[BENCH_MAX_LEDS];
+static FF_LED *groupTable[255];
+
+// Set first _count LEDs to a mode (0 = fixed, 1 = blink, 2 = pulse), with different timings
+void setMode(uint16_t _count, uint8_t _mode) {
+    for (uint16_t i = 0; i < _count; i++) {
+        if (_mode == 0) {
+            benchLeds[i].setFixed(i & 0xFF);
+        } else if (_mode == 1) {
+            benchLeds[i].setBlink(1 + (i % 3), 5 + (i % 7), 5 + (i % 11), 20);
+        } else {
+            benchLeds[i].setPulse(i & 1, 1 + (i % 2), 1 + (i % 3), 10);
+        }
+    }
+}
+
+// Print one cost result line
+void printCost(const __FlashStringHelper *_what, uint16_t _count, uint8_t _mode, unsigned long _micros, unsigned long _cycles, unsigned long _calls) {
+    Serial.print(_what);
+    Serial.print(F(" leds="));
+    Serial.print(_count);
+    Serial.print(F(" mode="));
+    Serial.print(modeNames[_mode]);
+    Serial.print(F(" calls="));
+    Serial.print(_calls);
+    Serial.print(F(" us/call="));
+    Serial.print((float) _micros / _calls, 3);
+    #ifdef BENCH_CYCLES
+        Serial.print(F(" cycles/call="));
+        Serial.print((float) _cycles / _calls, 1);
+    #else
+        (void) _cycles;
+    #endif
+    Serial.println();
+}
+
+// Time loop() of each LED, then loop() of a group with same LEDs
+void benchLoop(uint16_t _count, uint8_t _mode) {
+    setMode(_count, _mode);
+    unsigned long calls = 0;
+    unsigned long elapsed = 0;
+    unsigned long cycles = 0;
+    unsigned long start = millis();
+    while (millis() - start < BENCH_DURATION) {
+        unsigned long startMicros = micros();
+        #ifdef BENCH_CYCLES
+            unsigned long startCycles = BENCH_CYCLES();
+        #endif
+        for (uint16_t i = 0; i < _count; i++) {
+            benchLeds[i].loop();
+        }
+        #ifdef BENCH_CYCLES
+            cycles += BENCH_CYCLES() - startCycles;
+        #endif
+        elapsed += micros() - startMicros;
+        calls += _count;
+    }
+    printCost(F("FF_LED::loop()"), _count, _mode, elapsed, cycles, calls);
+
+    if (_count > 255) {
+        return;
+    }
+    FF_LEDGroup group(groupTable, _count);
+    for (uint16_t i = 0; i < _count; i++) {
+        group.add(&benchLeds[i]);
+    }
+    setMode(_count, _mode);
+    calls = 0;
+    elapsed = 0;
+    cycles = 0;
+    start = millis();
+    while (millis() - start < BENCH_DURATION) {
+        unsigned long startMicros = micros();
+        #ifdef BENCH_CYCLES
+            unsigned long startCycles = BENCH_CYCLES();
+        #endif
+        group.loop();
+        #ifdef BENCH_CYCLES
+            cycles += BENCH_CYCLES() - startCycles;
+        #endif
+        elapsed += micros() - startMicros;
+        calls++;
+    }
+    printCost(F("FF_LEDGroup::loop()"), _count, _mode, elapsed, cycles, calls);
+    for (uint16_t i = 0; i < _count; i++) {
+        group.remove(&benchLeds[i]);
+    }
+}
+
+// Time setFixed() (state change and output write)
+void benchSet(void) {
+    unsigned long calls = 0;
+    unsigned long elapsed = 0;
+    unsigned long cycles = 0;
+    unsigned long start = millis();
+    while (millis() - start < BENCH_DURATION) {
+        unsigned long startMicros = micros();
+        #ifdef BENCH_CYCLES
+            unsigned long startCycles = BENCH_CYCLES();
+        #endif
+        for (uint8_t i = 0; i < 100; i++) {
+            benchLeds[0].setFixed(i);
+        }
+        #ifdef BENCH_CYCLES
+            cycles += BENCH_CYCLES() - startCycles;
+        #endif
+        elapsed += micros() - startMicros;
+        calls += 100;
+    }
+    printCost(F("FF_LED::setFixed()"), 1, 0, elapsed, cycles, calls);
+}
+
+// Measure drift of first LED blink on time (_mode = 1) or pulse up step time (_mode = 2), other LEDs pulsing in same group
+void benchDrift(uint16_t _count, uint8_t _mode) {
+    FF_LEDGroup group(groupTable, _count);
+    for (uint16_t i = 0; i < _count; i++) {
+        group.add(&benchLeds[i]);
+    }
+    setMode(_count, 2);
+    benchLeds[0].setFixed(0);
+    benchOutput.probeValue = 0;
+    benchOutput.probeEnabled = true;
+    unsigned long requested;
+    if (_mode == 1) {
+        requested = BENCH_BLINK_ON;
+        benchLeds[0].setBlink(1, BENCH_BLINK_ON, BENCH_BLINK_OFF, 0);
+    } else {
+        requested = BENCH_PULSE_UP;
+        benchLeds[0].setPulse(true, BENCH_PULSE_UP, BENCH_PULSE_UP, 0);
+    }
+    long worst = 0;
+    long total = 0;
+    unsigned long samples = 0;
+    benchOutput.probeCount = 0;
+    unsigned long lastCount = 0;
+    bool lastRising = false;
+    unsigned long start = millis();
+    while (millis() - start < BENCH_DURATION) {
+        group.loop();
+        if (benchOutput.probeCount == lastCount) {
+            continue;
+        }
+        bool ignoreFirst = (lastCount == 0);   // First interval starts before effect
+        lastCount = benchOutput.probeCount;
+        bool rising = (benchOutput.probeValue == benchOutput.probePrevious + 1);
+        bool sample;
+        if (_mode == 1) {                       // End of on time
+            sample = benchOutput.probeValue == 0 && benchOutput.probePrevious == FF_LED_MAX_LEVEL;
+        } else {                                // Up step following another up step
+            sample = rising && lastRising;
+        }
+        lastRising = rising;
+        if (sample && !ignoreFirst) {
+            long drift = (long) benchOutput.probeInterval - (long) (requested * 1000UL);
+            total += drift;
+            samples++;
+            if (labs(drift) > labs(worst)) {
+                worst = drift;
+            }
+        }
+    }
+    Serial.print(F("drift leds="));
+    Serial.print(_count);
+    Serial.print(F(" mode="));
+    Serial.print(modeNames[_mode]);
+    Serial.print(F(" requested_us="));
+    Serial.print(requested * 1000UL);
+    Serial.print(F(" samples="));
+    Serial.print(samples);
+    Serial.print(F(" mean_us="));
+    Serial.print(samples ? (float) total / samples : 0.0, 1);
+    Serial.print(F(" worst_us="));
+    Serial.println(worst);
+    benchOutput.probeEnabled = false;
+    for (uint16_t i = 0; i < _count; i++) {
+        group.remove(&benchLeds[i]);
+    }
+}
+
+void setup() {
+    Serial.begin(115200);
+    while (!Serial && millis() < 3000) {
+    }
+    Serial.print(F("FF_LED bench, sizeof(FF_LED)="));
+    Serial.print(sizeof(FF_LED));
+    Serial.print(F(", max LEDs="));
+    Serial.println(BENCH_MAX_LEDS);
+    benchOutput.begin();
+    for (uint16_t i = 0; i < BENCH_MAX_LEDS; i++) {
+        benchLeds[i].begin();
+    }
+    for (uint8_t mode = 0; mode < 3; mode++) {
+        for (uint8_t c = 0; c < sizeof(benchCounts) / sizeof(benchCounts[0]); c++) {
+            if (benchCounts[c] <= BENCH_MAX_LEDS) {
+                benchLoop(benchCounts[c], mode);
+            }
+        }
+    }
+    benchSet();
+    uint16_t loaded = (BENCH_MAX_LEDS < 100) ? BENCH_MAX_LEDS : 100;
+    benchDrift(1, 1);
+    benchDrift(loaded, 1);
+    benchDrift(1, 2);
+    benchDrift(loaded, 2);
+    Serial.println(F("Done"));
+}
+
+void loop() {
+}
@@ -0,0 +1,84 @@
+/*!
+	\file
+	\brief	Minimal Arduino layer to build FF_LED on host (Linux, macOS) with a virtual clock
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Have a look at ArduinoHost.cpp for details
+
+*/
+
+
+#ifndef Arduino_h
+    #define Arduino_h
+    #include <stdint.h>
+    #include <stddef.h>
+    #include <stdio.h>
+    #include <stdlib.h>
+    #include <string.h>
+    #include <math.h>
+
+    #define INPUT 0
+    #define OUTPUT 1
+    #define LOW 0
+    #define HIGH 1
+    #define LED_BUILTIN 13
+
+    #define PROGMEM
+    #define PSTR(_string) (_string)
+    #define pgm_read_byte(_address) (*(const uint8_t *) (_address))
+    #define pgm_read_word(_address) (*(const uint16_t *) (_address))
+    #define pgm_read_dword(_address) (*(const uint32_t *) (_address))
+    #define memcpy_P memcpy
+    #define strlen_P strlen
+
+    class __FlashStringHelper;
+    #define F(_string) ((const __FlashStringHelper *) (_string))
+
+    unsigned long millis(void);
+    unsigned long micros(void);
+    void delay(unsigned long _ms);
+    void delayMicroseconds(unsigned int _us);
+    void pinMode(uint8_t _pin, uint8_t _mode);
+    void digitalWrite(uint8_t _pin, uint8_t _value);
+    void analogWrite(uint8_t _pin, int _value);
+    void analogWriteResolution(uint8_t _bits);
+    inline void noInterrupts(void) {}
+    inline void interrupts(void) {}
+
+    class FF_LEDHost {
+        /*!	\class FF_LEDHost
+            \brief Control of host layer: virtual clock and trace of pin writes
+        */
+        public:
+            static void setMillis(uint32_t _ms);
+            static void advanceMillis(uint32_t _ms);
+            static void advanceMicros(uint32_t _us);
+            static void setRealTime(bool _realTime);
+            static void setTrace(FILE *_trace);
+            static int getPin(uint8_t _pin);
+            static void trace(const char *_operation, unsigned int _channel, unsigned long _value);
+    };
+
+    class HostSerial {
+        /*!	\class HostSerial
+            \brief Serial printing to standard output
+        */
+        public:
+            void begin(unsigned long) {}
+            operator bool() {return true;}
+            void print(const char *_text) {fputs(_text, stdout);}
+            void print(const __FlashStringHelper *_text) {fputs((const char *) _text, stdout);}
+            void print(char _char) {fputc(_char, stdout);}
+            void print(int _value) {printf("%d", _value);}
+            void print(unsigned int _value) {printf("%u", _value);}
+            void print(long _value) {printf("%ld", _value);}
+            void print(unsigned long _value) {printf("%lu", _value);}
+            void print(double _value, int _digits = 2) {printf("%.*f", _digits, _value);}
+            void println(void) {fputc('\n', stdout);}
+            template <typename type> void println(type _value) {print(_value); println();}
+            void println(double _value, int _digits) {print(_value, _digits); println();}
+            template <typename... types> void printf(const char *_format, types... _values) {::printf(_format, _values...);}
+    };
+    extern HostSerial Serial;
+#endif
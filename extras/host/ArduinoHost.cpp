@@ -0,0 +1,177 @@
+/*!
+	\file
+	\brief	Minimal Arduino layer to build FF_LED on host (Linux, macOS) with a virtual clock
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Clock is virtual by default: millis() and micros() only move when program calls
+	FF_LEDHost::advanceMillis(), FF_LEDHost::advanceMicros(), FF_LEDHost::setMillis() or delay(),
+	so that months of LED effects are simulated in milliseconds, always giving the same results.
+	As on targets, millis() and micros() wrap at 2^32. Call FF_LEDHost::setRealTime(true)
+	to use host clock instead (benchmarks, perf, valgrind).
+
+	Each pin mode and write (and SPI/I2C byte of bus stubs) is written to trace file given to
+	FF_LEDHost::setTrace(), one line per operation: "<millis> <operation> <pin> <value>".
+	Traces of two versions may then be compared with diff.
+*/
+
+#include "Arduino.h"
+#include "SPI.h"
+#include "Wire.h"
+#include <chrono>
+#include <thread>
+
+HostSerial Serial;
+SPIClass SPI;
+TwoWire Wire;
+
+static uint64_t hostMicros = 0;                 // Virtual clock (in µs)
+static bool hostRealTime = false;               // Use host clock instead of virtual one?
+static FILE *hostTrace = nullptr;               // Trace file (nullptr if not traced)
+static int hostPins[256];                       // Last value written to each pin (digitalWrite() or analogWrite())
+
+/*!
+
+	\brief	Return current time in µs (64 bits)
+
+	\return	virtual clock, or µs since first call in real time mode
+
+*/
+static uint64_t hostNow(void) {
+    if (hostRealTime) {
+        static std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        return hostMicros + std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+    return hostMicros;
+}
+
+unsigned long millis(void) {
+    return (uint32_t) (hostNow() / 1000);       // Wraps as on targets
+}
+
+unsigned long micros(void) {
+    return (uint32_t) hostNow();
+}
+
+void delay(unsigned long _ms) {
+    if (hostRealTime) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(_ms));
+    } else {
+        hostMicros += 1000ULL * _ms;
+    }
+}
+
+void delayMicroseconds(unsigned int _us) {
+    if (hostRealTime) {
+        std::this_thread::sleep_for(std::chrono::microseconds(_us));
+    } else {
+        hostMicros += _us;
+    }
+}
+
+void pinMode(uint8_t _pin, uint8_t _mode) {
+    FF_LEDHost::trace("pinMode", _pin, _mode);
+}
+
+void digitalWrite(uint8_t _pin, uint8_t _value) {
+    hostPins[_pin] = _value;
+    FF_LEDHost::trace("digitalWrite", _pin, _value);
+}
+
+void analogWrite(uint8_t _pin, int _value) {
+    hostPins[_pin] = _value;
+    FF_LEDHost::trace("analogWrite", _pin, _value);
+}
+
+void analogWriteResolution(uint8_t _bits) {
+    FF_LEDHost::trace("analogWriteResolution", 0, _bits);
+}
+
+/*!
+
+	\brief	Set virtual clock
+
+	\param[in]	_ms: new millis() value
+	\return	none
+
+*/
+void FF_LEDHost::setMillis(uint32_t _ms) {
+    hostMicros = 1000ULL * _ms;
+}
+
+/*!
+
+	\brief	Move virtual clock forward
+
+	\param[in]	_ms: time to add (in ms)
+	\return	none
+
+*/
+void FF_LEDHost::advanceMillis(uint32_t _ms) {
+    hostMicros += 1000ULL * _ms;
+}
+
+/*!
+
+	\brief	Move virtual clock forward
+
+	\param[in]	_us: time to add (in µs)
+	\return	none
+
+*/
+void FF_LEDHost::advanceMicros(uint32_t _us) {
+    hostMicros += _us;
+}
+
+/*!
+
+	\brief	Select clock
+
+	\param[in]	_realTime: true to use host clock (starting from current virtual time), false for virtual clock
+	\return	none
+
+*/
+void FF_LEDHost::setRealTime(bool _realTime) {
+    hostMicros = hostNow();
+    hostRealTime = _realTime;
+}
+
+/*!
+
+	\brief	Set trace file
+
+	\param[in]	_trace: file where operations are written (nullptr to stop tracing)
+	\return	none
+
+*/
+void FF_LEDHost::setTrace(FILE *_trace) {
+    hostTrace = _trace;
+}
+
+/*!
+
+	\brief	Return last value written to a pin
+
+	\param[in]	_pin: pin to read
+	\return	last value given to digitalWrite() or analogWrite() (0 if never written)
+
+*/
+int FF_LEDHost::getPin(uint8_t _pin) {
+    return hostPins[_pin];
+}
+
+/*!
+
+	\brief	Write one operation to trace
+
+	\param[in]	_operation: operation name
+	\param[in]	_channel: pin (or bus address)
+	\param[in]	_value: written value
+	\return	none
+
+*/
+void FF_LEDHost::trace(const char *_operation, unsigned int _channel, unsigned long _value) {
+    if (hostTrace) {
+        fprintf(hostTrace, "%lu %s %u %lu\n", millis(), _operation, _channel, _value);
+    }
+}
@@ -0,0 +1,29 @@
+/*!
+	\file
+	\brief	SPI stub for host build, bytes are written to trace
+	\author	Flying Domotic
+	\date	December 1st, 2024
+*/
+
+
+#ifndef SPI_h
+    #define SPI_h
+    #include "Arduino.h"
+
+    #define MSBFIRST 1
+    #define SPI_MODE0 0
+
+    class SPISettings {
+        public:
+            SPISettings(uint32_t, uint8_t, uint8_t) {}
+    };
+
+    class SPIClass {
+        public:
+            void begin(void) {}
+            void beginTransaction(SPISettings) {}
+            uint8_t transfer(uint8_t _data) {FF_LEDHost::trace("spi", 0, _data); return 0;}
+            void endTransaction(void) {}
+    };
+    extern SPIClass SPI;
+#endif
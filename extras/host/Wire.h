@@ -0,0 +1,25 @@
+/*!
+	\file
+	\brief	Wire (I2C) stub for host build, bytes are written to trace
+	\author	Flying Domotic
+	\date	December 1st, 2024
+*/
+
+
+#ifndef Wire_h
+    #define Wire_h
+    #include "Arduino.h"
+
+    #define BUFFER_LENGTH 32
+
+    class TwoWire {
+        public:
+            void begin(void) {}
+            void beginTransmission(uint8_t _address) {wireAddress = _address;}
+            size_t write(uint8_t _data) {FF_LEDHost::trace("i2c", wireAddress, _data); return 1;}
+            uint8_t endTransmission(void) {return 0;}
+        private:
+            uint8_t wireAddress = 0;
+    };
+    extern TwoWire Wire;
+#endif
@@ -0,0 +1,167 @@
+/*!
+	\file
+	\brief	Host check: FF_LEDBatch gives the same outputs as FF_LED objects
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Same effects (fixed, blink, pulse, timed pulse, changed while running) are given to a batch
+	and to one FF_LED object per batch LED, both written to recording drivers. Clock advances
+	1 ms at a time, each side being run once per ms, and changes recorded by both drivers during
+	this ms (channel and value, sorted by channel, as sides don't write channels in the same order)
+	are compared, so that check doesn't depend on count of changes (pulse ramps of wide levels).
+	Run starts a few seconds before millis() wraps (or at given millis). Program returns 1 at first
+	difference.
+
+		./build.sh batchCheck.cpp && ./batchCheck [start millis]
+*/
+
+#include "FF_LEDBatch.h"
+#include "FF_LEDOutput.h"
+#include <algorithm>
+
+#define LED_COUNT 12                            // Count of LEDs on each side
+#define RUN_MS 60000UL                          // Simulated time (in ms)
+#define CHANGE_MS 25000UL                       // Time effects are changed (from start, in ms)
+#define MAX_CHANGES (8 * LED_COUNT)             // Trace size (in channel changes during one ms)
+
+class RecordOutput : public FF_LEDOutput {
+    /*!	\class RecordOutput
+        \brief Driver keeping trace of channel changes
+    */
+    public:
+        struct changeType {
+            uint32_t time;                      //!< millis() at change
+            uint8_t channel;                    //!< Changed channel
+            FF_LEDCore::ledLevelType value;     //!< New channel value
+        };
+        void begin(void) {}
+        void write(uint8_t _channel, FF_LEDCore::ledLevelType _value) {
+            if (written[_channel] && values[_channel] == _value) {
+                return;                         // Keep changes only, as FF_LED doesn't rewrite same value
+            }
+            written[_channel] = true;
+            values[_channel] = _value;
+            total++;
+            if (count < MAX_CHANGES) {
+                changes[count++] = {(uint32_t) millis(), _channel, _value};
+            }
+        }
+        /*! \brief Sort changes by channel, keeping order of changes of a channel */
+        void sort(void) {
+            std::stable_sort(changes, changes + count, [](const changeType &_a, const changeType &_b) {
+                return _a.channel < _b.channel;
+            });
+        }
+        changeType changes[MAX_CHANGES];        //!< Changes recorded since last compare
+        unsigned long count = 0;                //!< Count of recorded changes
+        unsigned long total = 0;                //!< Count of changes since start
+    protected:
+        void send(void) {}
+        bool written[LED_COUNT] = {};           //!< Channel got a value
+        FF_LEDCore::ledLevelType values[LED_COUNT] = {}; //!< Last value of channels
+};
+
+static RecordOutput batchOutput;
+static RecordOutput ledOutput;
+static FF_LEDBatchBuffers<LED_COUNT> batchBuffers;
+static FF_LEDBatch batch(batchBuffers);
+static FF_LED *leds[LED_COUNT];
+
+// Give effects to LED _led of both sides, second set (_change) being used while running
+static void setEffect(uint8_t _led, bool _change) {
+    FF_LED *led = leds[_led];
+    const FF_LEDCore::ledLevelType max = FF_LED_MAX_LEVEL;
+    switch (_change ? (_led + 5) % LED_COUNT : _led) {
+        case 0:
+            batch.setFixed(_led, max / 3); led->setFixed(max / 3);
+            break;
+        case 1:
+            batch.setFixed(_led, 0); led->setFixed(0);
+            break;
+        case 2:
+            batch.setBlink(_led, 3, 100, 200, 1000); led->setBlink(3, 100, 200, 1000);
+            break;
+        case 3:
+            batch.setBlink(_led, 1, 499, 499, 0, 10, max - 10); led->setBlink(1, 499, 499, 0, 10, max - 10);
+            break;
+        case 4:
+            batch.setBlink(_led, 0, 50, 50, 700); led->setBlink(0, 50, 50, 700);
+            break;
+        case 5:
+            batch.setPulse(_led, true, 2, 3, 500, 10, max / 2); led->setPulse(true, 2, 3, 500, 10, max / 2);
+            break;
+        case 6:
+            batch.setPulse(_led, false, 1, 1, 0); led->setPulse(false, 1, 1, 0);
+            break;
+        case 7:
+            batch.setPulse(_led, true, 0, 4, 100); led->setPulse(true, 0, 4, 100);
+            break;
+        case 8:
+            batch.setTimedPulse(_led, true, 1000, 500, 250); led->setTimedPulse(true, 1000, 500, 250);
+            break;
+        case 9:
+            batch.setTimedPulse(_led, false, 300, 700, 0, 20, max - 20); led->setTimedPulse(false, 300, 700, 0, 20, max - 20);
+            break;
+        case 10:
+            batch.setTimedPulse(_led, true, 0, 0, 0); led->setTimedPulse(true, 0, 0, 0);
+            break;
+        default:
+            batch.setTimedPulse(_led, false, 7, 3, 13, 0, 5); led->setTimedPulse(false, 7, 3, 13, 0, 5);
+            break;
+    }
+}
+
+// Compare changes recorded by both sides since previous call, then forget them
+static bool sameChanges(void) {
+    if (batchOutput.count >= MAX_CHANGES || ledOutput.count >= MAX_CHANGES) {
+        printf("Trace full at %lu\n", millis());
+        return false;
+    }
+    batchOutput.sort();
+    ledOutput.sort();
+    for (unsigned long i = 0; i < batchOutput.count || i < ledOutput.count; i++) {
+        RecordOutput::changeType *b = (i < batchOutput.count) ? &batchOutput.changes[i] : nullptr;
+        RecordOutput::changeType *l = (i < ledOutput.count) ? &ledOutput.changes[i] : nullptr;
+        if (!b || !l || b->time != l->time || b->channel != l->channel || b->value != l->value) {
+            printf("Difference at change %lu: batch %lu %d %d, LED %lu %d %d\n", batchOutput.total - batchOutput.count + i,
+                b ? (unsigned long) b->time : 0, b ? b->channel : -1, b ? (int) b->value : -1,
+                l ? (unsigned long) l->time : 0, l ? l->channel : -1, l ? (int) l->value : -1);
+            return false;
+        }
+    }
+    batchOutput.count = 0;
+    ledOutput.count = 0;
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    FF_LEDHost::setMillis(argc > 1 ? strtoul(argv[1], nullptr, 0) : 0xFFFFFFFFUL - CHANGE_MS - 5000);
+    batch.setOutput(&batchOutput);
+    batch.begin();
+    for (uint8_t i = 0; i < LED_COUNT; i++) {
+        leds[i] = new FF_LED(&ledOutput, i);
+        leds[i]->begin();
+        setEffect(i, false);
+    }
+    for (unsigned long elapsed = 0; elapsed < RUN_MS; elapsed++) {
+        if (elapsed == CHANGE_MS) {
+            for (uint8_t i = 0; i < LED_COUNT; i++) {
+                setEffect(i, true);             // Change effects while running
+            }
+        }
+        batch.loop();
+        for (uint8_t i = 0; i < LED_COUNT; i++) {
+            leds[i]->loop();
+        }
+        if (!sameChanges()) {
+            return 1;
+        }
+        FF_LEDHost::advanceMillis(1);
+    }
+    printf("Batch: %lu changes, LEDs: %lu changes\n", batchOutput.total, ledOutput.total);
+    if (batchOutput.total != ledOutput.total) {
+        return 1;
+    }
+    printf("Same outputs\n");
+    return 0;
+}
@@ -0,0 +1,22 @@
+#!/bin/bash
+# Build FF_LED for host, with a sketch (.ino, run by hostMain.cpp) or a program having its own main() (.cpp)
+# Usage: build.sh <sketch.ino|program.cpp> [output] [compiler options]
+# Example: build.sh ../../examples/bench/bench.ino bench -O2 && ./bench --realtime
+if [ -z "$1" ]; then
+    echo "Usage: $0 <sketch.ino|program.cpp> [output] [compiler options]"
+    exit 1
+fi
+source="$1"
+output="${2:-$(basename "${source%.*}")}"
+shift
+[ -n "$1" ] && shift
+host="$(cd "$(dirname "$0")" && pwd)"
+root="$(cd "$host/../.." && pwd)"
+files=("$root"/*.cpp "$host/ArduinoHost.cpp")
+if [[ "$source" == *.ino ]]; then
+    files+=("$host/hostMain.cpp")
+    sources=(-x c++ -include Arduino.h "$source" -x none)
+else
+    sources=("$source")
+fi
+${CXX:-g++} -std=gnu++11 -g -Wall -Wextra -I"$host" -I"$root" "$@" "${sources[@]}" "${files[@]}" -o "$output"
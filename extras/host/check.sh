@@ -0,0 +1,24 @@
+#!/bin/bash
+# Build and run host checks (longRun, batchCheck) in several library configurations, stop at first failure
+# Usage: check.sh [compiler options added to each configuration]
+# Example: check.sh -O2
+host="$(cd "$(dirname "$0")" && pwd)"
+output="$(mktemp -d)"
+trap 'rm -rf "$output"' EXIT
+configurations=(
+    ""
+    "-DFF_LED_COMPACT"
+    "-DFF_LED_COMPACT -DFF_LED_TICK_MS=8"
+    "-DFF_LED_LEVEL_BITS=12"
+    "-DFF_LED_LEVEL_BITS=16"
+    "-DFF_LED_COMPACT -DFF_LED_LEVEL_BITS=16"
+)
+for configuration in "${configurations[@]}"; do
+    for check in longRun batchCheck; do
+        echo "== $check ${configuration:-(default)}"
+        # shellcheck disable=SC2086
+        "$host/build.sh" "$host/$check.cpp" "$output/$check" -O2 $configuration "$@" || exit 1
+        "$output/$check" || exit 1
+    done
+done
+echo "All checks passed"
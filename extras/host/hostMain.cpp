@@ -0,0 +1,53 @@
+/*!
+	\file
+	\brief	main() running an Arduino sketch on host
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Calls setup(), then loop() until given duration elapsed, moving virtual clock between loops.
+
+	Options:
+		--realtime: use host clock (default to virtual clock)
+		--duration <ms>: time to run loop() (default to 60000 ms)
+		--step <ms>: virtual time between 2 loop() calls (default to 1 ms)
+		--start <ms>: initial millis() value (default to 0, use 4294900000 to test clock wrap)
+		--trace <file>: write pin operations to file ("-" for standard output)
+*/
+
+#include "Arduino.h"
+
+void setup(void);
+void loop(void);
+
+int main(int argc, char *argv[]) {
+    bool realTime = false;
+    unsigned long duration = 60000;
+    unsigned long step = 1;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--realtime")) {
+            realTime = true;
+        } else if (!strcmp(argv[i], "--duration") && i + 1 < argc) {
+            duration = strtoul(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--step") && i + 1 < argc) {
+            step = strtoul(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--start") && i + 1 < argc) {
+            FF_LEDHost::setMillis(strtoul(argv[++i], nullptr, 0));
+        } else if (!strcmp(argv[i], "--trace") && i + 1 < argc) {
+            i++;
+            FF_LEDHost::setTrace(strcmp(argv[i], "-") ? fopen(argv[i], "w") : stdout);
+        } else {
+            fprintf(stderr, "Usage: %s [--realtime] [--duration <ms>] [--step <ms>] [--start <ms>] [--trace <file>]\n", argv[0]);
+            return 1;
+        }
+    }
+    FF_LEDHost::setRealTime(realTime);
+    unsigned long start = millis();
+    setup();
+    while (millis() - start < duration) {
+        loop();
+        if (!realTime) {
+            FF_LEDHost::advanceMillis(step);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+/*!
+	\file
+	\brief	Host simulation example: run a blinking LED for 60 days in a few seconds
+	\author	Flying Domotic
+	\date	December 1st, 2024
+
+	Clock jumps directly to next change returned by loop(), so only useful loops are run.
+	Count of blinks (rising edges of pin) is compared to expected one, and trace may be written to
+	compare versions. Program returns 1 if counts differ.
+
+		./build.sh longRun.cpp && ./longRun [trace file] [start millis]
+*/
+
+#include "FF_LED.h"
+
+#define RUN_DAYS 60UL                           // Simulated time (in days)
+#define ON_TIME 499                             // Blink on time (in ms, changes when time exceeds it)
+#define OFF_TIME 499                            // Blink off time (in ms)
+
+int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        FF_LEDHost::setTrace(fopen(argv[1], "w"));
+    }
+    if (argc > 2) {
+        FF_LEDHost::setMillis(strtoul(argv[2], nullptr, 0));
+    }
+    FF_LED led(LED_BUILTIN);
+    led.begin();
+    led.setBlink(1, ON_TIME, OFF_TIME, 0);
+    uint64_t simulated = 0;                     // Simulated time (in ms, doesn't wrap)
+    unsigned long loops = 0;
+    uint64_t blinks = 0;
+    int previousPin = FF_LEDHost::getPin(LED_BUILTIN);
+    while (simulated < RUN_DAYS * 86400000ULL) {
+        unsigned long wait = led.loop();
+        loops++;
+        int pin = FF_LEDHost::getPin(LED_BUILTIN);
+        if (pin && !previousPin) {
+            blinks++;                           // Rising edge
+        }
+        previousPin = pin;
+        if (wait == FF_LED_WAIT_FOR_EVER) {
+            break;
+        }
+        if (!wait) {
+            wait = 1;
+        }
+        FF_LEDHost::advanceMillis(wait);
+        simulated += wait;
+    }
+    // Each cycle: on for ON_TIME + 1 tick, off for OFF_TIME + 1 tick, then wait 0 + 1 tick (times rounded down to ticks)
+    uint64_t expected = simulated / ((ON_TIME / FF_LED_TICK_MS + OFF_TIME / FF_LED_TICK_MS + 3) * FF_LED_TICK_MS);
+    printf("Simulated %llu ms in %lu loops, %llu blinks, %llu expected\n", (unsigned long long) simulated, loops, (unsigned long long) blinks, (unsigned long long) expected);
+    if (blinks != expected) {
+        printf("Blink count mismatch\n");
+        return 1;
+    }
+    return 0;
+}